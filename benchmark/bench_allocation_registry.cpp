@@ -0,0 +1,75 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "allocation_registry.hpp"
+
+namespace {
+
+constexpr std::uint64_t heap_base = 0x7f0000000000;
+
+// A caching allocator's steady state: blocks of mixed sizes freed and
+// reallocated by every thread.
+void BM_allocate_free(benchmark::State& state) {
+  static maestro::allocation_registry registry;
+  const std::uint64_t base = heap_base + (std::uint64_t(state.thread_index()) << 36);
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    const auto ptr = base + (i % 1024) * 0x100000;
+    registry.add(ptr, 0x1000 << (i % 8), 1, maestro::allocation_source::MEMORY_POOL);
+    benchmark::DoNotOptimize(registry.remove(ptr));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_allocate_free)->ThreadRange(1, 8)->UseRealTime();
+
+// Interior pointers looked up against n live allocations
+void BM_find_interior(benchmark::State& state) {
+  const auto n = static_cast<std::uint64_t>(state.range(0));
+  maestro::allocation_registry registry;
+  for (std::uint64_t i = 0; i < n; i++) {
+    registry.add(heap_base + i * 0x200000,
+                 0x100000,
+                 1,
+                 maestro::allocation_source::MEMORY_POOL);
+  }
+  std::mt19937_64 rng(42);
+  std::vector<std::uint64_t> addresses(4096);
+  for (auto& address : addresses) {
+    address = heap_base + rng() % (n * 0x200000);
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(registry.find(addresses[i++ & 4095]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_find_interior)->RangeMultiplier(8)->Range(8, 32768);
+
+}  // namespace
@@ -0,0 +1,80 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "code_object.hpp"
+
+namespace {
+
+std::vector<char> make_code_object(std::size_t size) {
+  std::vector<char> buffer(size);
+  std::mt19937_64 rng(42);
+  std::generate(
+      buffer.begin(), buffer.end(), [&rng] { return static_cast<char>(rng()); });
+  // Code objects start with the same ELF header
+  const char elf_magic[] = {0x7f, 'E', 'L', 'F', 2, 1, 1, 0x40};
+  std::copy(std::begin(elf_magic), std::end(elf_magic), buffer.begin());
+  return buffer;
+}
+
+// What nexus used before: std::hash over the first 512 bytes only.
+void BM_hash_prefix_512(benchmark::State& state) {
+  const auto buffer = make_code_object(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    const std::string prefix(buffer.data(), std::min<std::size_t>(512, buffer.size()));
+    benchmark::DoNotOptimize(std::hash<std::string>{}(prefix));
+  }
+}
+BENCHMARK(BM_hash_prefix_512)->RangeMultiplier(4)->Range(1 << 20, 64 << 20);
+
+void BM_hash_std_full(benchmark::State& state) {
+  const auto buffer = make_code_object(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::hash<std::string_view>{}(std::string_view(buffer.data(), buffer.size())));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_hash_std_full)->RangeMultiplier(4)->Range(1 << 20, 64 << 20);
+
+void BM_hash_xxh3_128(benchmark::State& state) {
+  const auto buffer = make_code_object(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(maestro::hash_code_object(buffer.data(), buffer.size()));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_hash_xxh3_128)->RangeMultiplier(4)->Range(1 << 20, 64 << 20);
+
+}  // namespace
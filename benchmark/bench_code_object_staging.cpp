@@ -0,0 +1,100 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "code_object.hpp"
+
+namespace {
+
+// An AMDGPU ELF header followed by random "text"; enough for registration,
+// which never looks past the bytes.
+std::vector<char> make_synthetic_elf(std::size_t size) {
+  std::vector<char> buffer(size);
+  std::mt19937_64 rng(7);
+  for (auto& byte : buffer) {
+    byte = static_cast<char>(rng());
+  }
+  Elf64_Ehdr header{};
+  std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+  header.e_ident[EI_CLASS] = ELFCLASS64;
+  header.e_ident[EI_DATA] = ELFDATA2LSB;
+  header.e_ident[EI_VERSION] = EV_CURRENT;
+  header.e_type = ET_DYN;
+  header.e_machine = 224;  // EM_AMDGPU
+  header.e_version = EV_CURRENT;
+  header.e_ehsize = sizeof(Elf64_Ehdr);
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  return buffer;
+}
+
+// Reads the staged object back by path, the way kernelDB ingests it
+std::size_t read_back(const std::string& path, std::vector<char>& scratch) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  std::size_t total = 0;
+  ssize_t n;
+  while ((n = ::read(fd, scratch.data(), scratch.size())) > 0) {
+    total += static_cast<std::size_t>(n);
+  }
+  ::close(fd);
+  return total;
+}
+
+void BM_register(benchmark::State& state, maestro::staging mode) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  const auto elf = make_synthetic_elf(size);
+  std::vector<char> scratch(1 << 20);
+  std::uint64_t generation = 0;
+  for (auto _ : state) {
+    // A distinct hash per iteration, like a stream of new JIT kernels
+    auto hash = maestro::hash_code_object(elf.data(), elf.size());
+    hash.low ^= generation++;
+    auto staged = maestro::staged_code_object::stage(elf.data(), elf.size(), hash, mode);
+    benchmark::DoNotOptimize(read_back(staged->path(), scratch));
+    if (!staged->in_memory()) {
+      std::filesystem::remove(staged->path());
+    }
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK_CAPTURE(BM_register, temp_file, maestro::staging::TEMP_FILE)
+    ->RangeMultiplier(4)
+    ->Range(64 << 10, 16 << 20)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_register, memfd, maestro::staging::MEMFD)
+    ->RangeMultiplier(4)
+    ->Range(64 << 10, 16 << 20)
+    ->UseRealTime();
+
+}  // namespace
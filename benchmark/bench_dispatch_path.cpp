@@ -0,0 +1,140 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kernel_cache.hpp"
+#include "packet_batch.hpp"
+#include "symbol_table.hpp"
+
+namespace {
+
+constexpr std::size_t batch_size = 16;
+constexpr std::uint64_t num_kernels = 64;
+// Offset of kernel_object in hsa_kernel_dispatch_packet_t
+constexpr std::size_t kernel_object_offset = 32;
+
+std::uint64_t kernel_object(std::uint64_t i) {
+  return 0x7f0000000000 + i * 0x100;
+}
+
+// Per-thread queue batches of warm kernels, each thread on its own stream
+std::vector<unsigned char> make_batch(std::uint64_t first) {
+  std::vector<unsigned char> slots(batch_size * maestro::aql_packet_size);
+  for (std::size_t i = 0; i < batch_size; i++) {
+    auto* slot = &slots[i * maestro::aql_packet_size];
+    const std::uint16_t header = maestro::aql_kernel_dispatch_type | (1 << 8);
+    const auto object = kernel_object((first + i) % num_kernels);
+    std::memcpy(slot, &header, sizeof(header));
+    std::memcpy(slot + kernel_object_offset, &object, sizeof(object));
+  }
+  return slots;
+}
+
+std::uint64_t read_kernel_object(const unsigned char* slots, std::uint32_t index) {
+  std::uint64_t object;
+  std::memcpy(&object,
+              slots + index * maestro::aql_packet_size + kernel_object_offset,
+              sizeof(object));
+  return object;
+}
+
+// The previous layout: every lookup on the dispatch path took one global mutex
+struct locked_state {
+  std::mutex mutex;
+  std::unordered_map<std::uint64_t, std::string> names;
+  std::unordered_map<std::uint64_t, bool> traced;
+};
+
+locked_state& shared_locked_state() {
+  static locked_state* state = [] {
+    auto* s = new locked_state;
+    for (std::uint64_t i = 0; i < num_kernels; i++) {
+      s->names[kernel_object(i)] = "vector_add_" + std::to_string(i);
+      s->traced[kernel_object(i)] = i % 2 == 0;
+    }
+    return s;
+  }();
+  return *state;
+}
+
+struct sharded_state {
+  maestro::kernel_cache cache;
+  maestro::symbol_table symbols;
+};
+
+sharded_state& shared_sharded_state() {
+  static sharded_state* state = [] {
+    auto* s = new sharded_state;
+    for (std::uint64_t i = 0; i < num_kernels; i++) {
+      const auto name = "vector_add_" + std::to_string(i);
+      s->symbols.add_symbol(i + 1, name, name);
+      s->symbols.add_kernel_object(kernel_object(i), i + 1);
+      s->cache.insert(kernel_object(i), name, i % 2 == 0);
+    }
+    return s;
+  }();
+  return *state;
+}
+
+void BM_dispatch_global_mutex(benchmark::State& state) {
+  auto& shared = shared_locked_state();
+  const auto slots = make_batch(state.thread_index() * 7);
+  std::uint32_t dispatches[batch_size];
+  for (auto _ : state) {
+    const auto count = maestro::find_dispatches(slots.data(), batch_size, dispatches);
+    for (std::size_t i = 0; i < count; i++) {
+      const auto object = read_kernel_object(slots.data(), dispatches[i]);
+      std::lock_guard g(shared.mutex);
+      benchmark::DoNotOptimize(shared.names.find(object));
+      benchmark::DoNotOptimize(shared.traced.find(object));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_dispatch_global_mutex)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_dispatch_sharded(benchmark::State& state) {
+  auto& shared = shared_sharded_state();
+  const auto slots = make_batch(state.thread_index() * 7);
+  std::uint32_t dispatches[batch_size];
+  for (auto _ : state) {
+    const auto count = maestro::find_dispatches(slots.data(), batch_size, dispatches);
+    for (std::size_t i = 0; i < count; i++) {
+      const auto object = read_kernel_object(slots.data(), dispatches[i]);
+      benchmark::DoNotOptimize(shared.cache.hit(object));
+      benchmark::DoNotOptimize(shared.symbols.find(object));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_dispatch_sharded)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,83 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "dispatch_pipeline.hpp"
+
+namespace {
+
+maestro::dispatch_record make_record(std::uint64_t i) {
+  return {0x7f0000000000 + (i % 64) * 0x100};
+}
+
+// Cost of the submit path alone, with workers running a trivial handler.
+void BM_submit(benchmark::State& state) {
+  static maestro::dispatch_pipeline* pipeline = nullptr;
+  if (state.thread_index() == 0) {
+    pipeline = new maestro::dispatch_pipeline(
+        [](const maestro::dispatch_record& record) {
+          benchmark::DoNotOptimize(record.kernel_object);
+        },
+        4096,
+        1,
+        static_cast<maestro::backpressure>(state.range(0)),
+        16);
+  }
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pipeline->submit(make_record(i++)));
+  }
+  if (state.thread_index() == 0) {
+    const auto counters = pipeline->get_counters();
+    delete pipeline;
+    state.counters["dropped"] = static_cast<double>(counters.dropped);
+    state.counters["sampled_out"] = static_cast<double>(counters.sampled_out);
+  }
+}
+BENCHMARK(BM_submit)
+    ->ArgName("mode")
+    ->Arg(static_cast<int>(maestro::backpressure::DROP))
+    ->Arg(static_cast<int>(maestro::backpressure::BLOCK))
+    ->Arg(static_cast<int>(maestro::backpressure::SAMPLE))
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Raw ring throughput without workers: push one, pop one.
+void BM_ring_push_pop(benchmark::State& state) {
+  maestro::mpmc_ring<maestro::dispatch_record> ring(1024);
+  maestro::dispatch_record out{};
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    ring.try_push(make_record(i++));
+    ring.try_pop(out);
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_ring_push_pop);
+
+}  // namespace
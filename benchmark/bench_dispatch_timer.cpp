@@ -0,0 +1,106 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "dispatch_timer.hpp"
+
+namespace {
+
+// Fake runtime: signals are plain integers and a "device" thread completes
+// every attached signal in submission order.
+struct fake_device {
+  maestro::mpmc_ring<std::pair<maestro::dispatch_timer_api::completion_handler, void*>>
+      pending{1 << 16};
+  std::atomic<std::uint64_t> next_signal{1};
+  std::atomic<std::uint64_t> clock{0};
+  std::atomic<std::uint64_t> forwarded{0};
+  std::atomic<bool> stop{false};
+  std::thread thread;
+
+  fake_device() {
+    thread = std::thread([this]() {
+      std::pair<maestro::dispatch_timer_api::completion_handler, void*> p;
+      while (!stop.load(std::memory_order_acquire)) {
+        if (pending.try_pop(p)) {
+          p.first(0, p.second);
+        }
+      }
+    });
+  }
+  ~fake_device() {
+    stop.store(true, std::memory_order_release);
+    thread.join();
+  }
+};
+
+fake_device* device = nullptr;
+
+maestro::dispatch_timer_api fake_api() {
+  maestro::dispatch_timer_api api{};
+  api.signal_create = [](std::uint64_t* signal) {
+    *signal = device->next_signal.fetch_add(1);
+    return true;
+  };
+  api.signal_destroy = [](std::uint64_t) {};
+  api.signal_reset = [](std::uint64_t) {};
+  api.signal_forward = [](std::uint64_t) { device->forwarded.fetch_add(1); };
+  api.on_completion = [](std::uint64_t,
+                         maestro::dispatch_timer_api::completion_handler handler,
+                         void* arg) { return device->pending.try_push({handler, arg}); };
+  api.dispatch_time =
+      [](std::uint64_t, std::uint64_t, std::uint64_t* start, std::uint64_t* end) {
+        *start = device->clock.fetch_add(1000);
+        *end = *start + 250;
+        return true;
+      };
+  return api;
+}
+
+// Cost on the submit path of swapping in a pooled signal, with completions
+// and harvesting running concurrently.
+void BM_attach(benchmark::State& state) {
+  fake_device fake;
+  device = &fake;
+  maestro::dispatch_timer timer(fake_api(), state.range(0));
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    // Half of the dispatches carry an application signal to forward
+    benchmark::DoNotOptimize(
+        timer.attach(0x7f0000000000 + (i & 63) * 0x100, 1, i & 1 ? 42 : 0));
+    i++;
+  }
+  timer.stop();
+  const auto counters = timer.get_counters();
+  state.counters["timed"] = counters.completed;
+  state.counters["exhausted"] = counters.exhausted;
+  device = nullptr;
+}
+BENCHMARK(BM_attach)->Arg(64)->Arg(4096);
+
+}  // namespace
@@ -0,0 +1,96 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "extraction_cache.hpp"
+
+namespace {
+
+const std::filesystem::path cache_dir =
+    std::filesystem::temp_directory_path() / "nexus_bench_extraction_cache";
+const std::filesystem::path source_path =
+    std::filesystem::temp_directory_path() / "nexus_bench_extraction_cache.hip";
+
+// A kernel of n source lines with 8 instructions per line
+struct kernel {
+  std::vector<std::string> isa;
+  maestro::kernel_record record;
+};
+
+kernel make_kernel(std::size_t num_lines) {
+  std::ofstream(source_path) << "__global__ void vector_add() {}\n";
+  kernel k;
+  for (std::size_t i = 0; i < num_lines * 8; i++) {
+    k.isa.push_back("v_add_f32_e32 v" + std::to_string(i % 32) + ", v1, v2 // " +
+                    std::to_string(i));
+  }
+  k.record.name = "vector_add(float const*, float const*, float*, int)";
+  k.record.signature = k.record.name;
+  for (std::size_t i = 0; i < num_lines; i++) {
+    k.record.lines.push_back(static_cast<std::uint32_t>(10 + i));
+    k.record.files.push_back(source_path.string());
+    k.record.hip.push_back("    c[idx] = a[idx] + b[idx]; // " + std::to_string(i));
+  }
+  for (std::size_t i = 0; i < k.isa.size(); i++) {
+    k.record.assembly.push_back(k.isa[i]);
+    k.record.source_index.push_back(static_cast<std::int32_t>(i / 8));
+  }
+  return k;
+}
+
+void BM_cache_store(benchmark::State& state) {
+  std::filesystem::remove_all(cache_dir);
+  maestro::extraction_cache cache(cache_dir, std::uint64_t{1} << 30);
+  const auto k = make_kernel(static_cast<std::size_t>(state.range(0)));
+  const auto key = maestro::extraction_cache::key({{1, 2}}, k.record.name, "");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.store(key, k.record, {source_path.string()}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_cache_store)->Arg(16)->Arg(256)->Arg(4096);
+
+// A hit: map, verify, stat the source file and parse
+void BM_cache_load(benchmark::State& state) {
+  std::filesystem::remove_all(cache_dir);
+  maestro::extraction_cache cache(cache_dir, std::uint64_t{1} << 30);
+  const auto k = make_kernel(static_cast<std::size_t>(state.range(0)));
+  const auto key = maestro::extraction_cache::key({{1, 2}}, k.record.name, "");
+  cache.store(key, k.record, {source_path.string()});
+  for (auto _ : state) {
+    auto entry = cache.load(key);
+    benchmark::DoNotOptimize(entry->record.assembly.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_cache_load)->Arg(16)->Arg(256)->Arg(4096);
+
+}  // namespace
@@ -0,0 +1,122 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "isa_store.hpp"
+
+namespace {
+
+// Disassembly as kernelDB keeps it: a leading tab and one after the mnemonic
+std::vector<std::string> make_instructions(std::size_t count) {
+  std::vector<std::string> instructions;
+  for (std::size_t i = 0; i < count; i++) {
+    instructions.push_back("\tglobal_load_dwordx4\tv[" + std::to_string(i % 64) +
+                           ":" + std::to_string(i % 64 + 3) +
+                           "], v[2:3], off offset:" + std::to_string(i * 16));
+  }
+  return instructions;
+}
+
+void BM_strip_erase_remove(benchmark::State& state) {
+  const auto instructions = make_instructions(4096);
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto& instruction : instructions) {
+      std::string copy = instruction;
+      copy.erase(std::remove(copy.begin(), copy.end(), '\t'), copy.end());
+      bytes += instruction.size();
+      benchmark::DoNotOptimize(copy.data());
+    }
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_strip_erase_remove);
+
+void BM_strip_tabs(benchmark::State& state) {
+  const auto instructions = make_instructions(4096);
+  std::string out(256, '\0');
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto& instruction : instructions) {
+      out.resize(std::max(out.size(), instruction.size()));
+      benchmark::DoNotOptimize(maestro::strip_tabs(instruction, out.data()));
+      bytes += instruction.size();
+    }
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_strip_tabs);
+
+// range(0) kernels, of which every range(1)-th has its own body; the rest are
+// clones. Compares per-kernel string vectors with the interned store.
+void BM_isa_copies(benchmark::State& state) {
+  const auto kernels = static_cast<std::size_t>(state.range(0));
+  const auto instructions = make_instructions(kernels / state.range(1) * 256);
+  for (auto _ : state) {
+    std::vector<std::vector<std::string>> copies(kernels);
+    std::size_t bytes = 0;
+    for (std::size_t k = 0; k < kernels; k++) {
+      const auto body = k / state.range(1);
+      for (std::size_t i = 0; i < 256; i++) {
+        std::string instruction = instructions[body * 256 + i];
+        std::erase(instruction, '\t');
+        bytes += instruction.size();
+        copies[k].push_back(std::move(instruction));
+      }
+    }
+    state.counters["bytes"] = static_cast<double>(bytes);
+  }
+}
+BENCHMARK(BM_isa_copies)->Args({1024, 1})->Args({1024, 8});
+
+void BM_isa_store(benchmark::State& state) {
+  const auto kernels = static_cast<std::size_t>(state.range(0));
+  const auto instructions = make_instructions(kernels / state.range(1) * 256);
+  std::vector<std::string> names;
+  for (std::size_t k = 0; k < kernels; k++) {
+    names.push_back("_Z6kernelILi" + std::to_string(k) + "EEvPf");
+  }
+  std::vector<std::string_view> raw;
+  for (auto _ : state) {
+    maestro::isa_store store;
+    for (std::size_t k = 0; k < kernels; k++) {
+      const auto body = k / state.range(1);
+      raw.assign(instructions.begin() + body * 256,
+                 instructions.begin() + (body + 1) * 256);
+      benchmark::DoNotOptimize(&store.intern(names[k], raw));
+    }
+    const auto stats = store.get_stats();
+    state.counters["bytes"] = static_cast<double>(stats.arena_bytes);
+    state.counters["bodies"] = static_cast<double>(stats.unique_blocks);
+  }
+}
+BENCHMARK(BM_isa_store)->Args({1024, 1})->Args({1024, 8});
+
+}  // namespace
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "allocation_registry.hpp"
+#include "kernarg_scan.hpp"
+
+namespace {
+
+constexpr std::uint64_t heap_base = 0x7f0000000000;
+
+// Cost seen by the queue-intercept callback for a kernel with n argument words
+void BM_submit(benchmark::State& state) {
+  const auto num_words = static_cast<std::size_t>(state.range(0));
+  maestro::allocation_registry registry;
+  maestro::kernarg_scanner scanner(registry, 1024);
+  std::vector<std::uint64_t> kernarg(num_words, heap_base);
+  for (auto _ : state) {
+    scanner.submit(1, kernarg.data(), num_words * sizeof(std::uint64_t));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_submit)->Arg(4)->Arg(16)->Arg(64);
+
+// Resolving a batch's kernarg words against n live allocations, one lookup
+// per word versus one sorted pass per shard
+void BM_resolve(benchmark::State& state, bool batched) {
+  const auto n = static_cast<std::uint64_t>(state.range(0));
+  maestro::allocation_registry registry;
+  for (std::uint64_t i = 0; i < n; i++) {
+    registry.add(heap_base + i * 0x200000,
+                 0x100000,
+                 1,
+                 maestro::allocation_source::MEMORY_POOL);
+  }
+  // 256 dispatches of 8 words: pointers, sizes and scalars
+  std::vector<std::uint64_t> words(256 * 8);
+  for (std::size_t i = 0; i < words.size(); i++) {
+    words[i] = i % 4 == 3 ? i : heap_base + (i * 7919 % n) * 0x200000 + i % 64;
+  }
+  std::vector<std::optional<maestro::allocation>> out(words.size());
+  for (auto _ : state) {
+    if (batched) {
+      benchmark::DoNotOptimize(
+          registry.find_many(words.data(), words.size(), out.data()));
+    } else {
+      for (std::size_t i = 0; i < words.size(); i++) {
+        out[i] = registry.find(words[i]);
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * words.size());
+}
+BENCHMARK_CAPTURE(BM_resolve, per_word, false)->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_resolve, batched, true)->Arg(64)->Arg(4096);
+
+}  // namespace
@@ -0,0 +1,97 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "kernel_cache.hpp"
+
+namespace {
+
+// Stand-in for the kernelDB query, source reads and serialization done for a
+// kernel on its first dispatch.
+std::string extract_synthetic_kernel(const std::string& name,
+                                     std::size_t num_lines,
+                                     std::size_t num_instructions) {
+  nlohmann::json record;
+  nlohmann::json lines = nlohmann::json::array();
+  nlohmann::json files = nlohmann::json::array();
+  nlohmann::json hip = nlohmann::json::array();
+  nlohmann::json assembly = nlohmann::json::array();
+  for (std::size_t i = 0; i < num_lines; i++) {
+    lines.push_back(i + 1);
+    files.push_back("/workspace/kernels/vector_add.hip");
+    hip.push_back("  c[idx] = a[idx] + b[idx]; // line " + std::to_string(i));
+  }
+  for (std::size_t i = 0; i < num_instructions; i++) {
+    assembly.push_back("v_add_f32_e32 v" + std::to_string(i % 256) + ", v1, v2");
+  }
+  record["kernels"][name]["lines"] = std::move(lines);
+  record["kernels"][name]["files"] = std::move(files);
+  record["kernels"][name]["hip"] = std::move(hip);
+  record["kernels"][name]["assembly"] = std::move(assembly);
+  record["kernels"][name]["signature"] = name;
+  return record.dump(4);
+}
+
+void dispatch(maestro::kernel_cache& cache, std::uint64_t kernel_object) {
+  if (cache.hit(kernel_object)) {
+    return;
+  }
+  const std::string name = "vector_add_" + std::to_string(kernel_object);
+  benchmark::DoNotOptimize(extract_synthetic_kernel(name, 64, 512));
+  cache.insert(kernel_object, name, true);
+}
+
+// Every dispatch is the first one for its kernel_object.
+void BM_dispatch_cold(benchmark::State& state) {
+  maestro::kernel_cache cache;
+  std::uint64_t kernel_object = 0x7f0000000000;
+  for (auto _ : state) {
+    dispatch(cache, kernel_object);
+    kernel_object += 0x100;
+  }
+}
+BENCHMARK(BM_dispatch_cold);
+
+// A working set of already extracted kernels dispatched round-robin.
+void BM_dispatch_warm(benchmark::State& state) {
+  const auto num_kernels = static_cast<std::uint64_t>(state.range(0));
+  maestro::kernel_cache cache;
+  for (std::uint64_t i = 0; i < num_kernels; i++) {
+    cache.insert(0x7f0000000000 + i * 0x100, "vector_add_" + std::to_string(i), true);
+  }
+  std::uint64_t i = 0;
+  for (auto _ : state) {
+    dispatch(cache, 0x7f0000000000 + i * 0x100);
+    i = (i + 1 == num_kernels) ? 0 : i + 1;
+  }
+}
+BENCHMARK(BM_dispatch_warm)->Arg(1)->Arg(64)->Arg(512)->Arg(4096);
+
+}  // namespace
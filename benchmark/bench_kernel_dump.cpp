@@ -0,0 +1,119 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "kernel_dump.hpp"
+
+namespace {
+
+constexpr std::size_t instructions_per_kernel = 128;
+// Template instantiations: kernels with the same index modulo this share a body
+constexpr std::size_t distinct_bodies = 16;
+
+struct corpus {
+  std::vector<std::string> kernels;
+  std::vector<std::vector<std::string>> bodies;
+  std::unordered_map<std::string, std::size_t> body_of;
+};
+
+corpus make_corpus(std::size_t count) {
+  corpus c;
+  for (std::size_t b = 0; b < distinct_bodies; b++) {
+    auto& body = c.bodies.emplace_back();
+    for (std::size_t i = 0; i < instructions_per_kernel; i++) {
+      body.push_back("\tv_fma_f32 v" + std::to_string(i % 64) + ", v1, v2, v3 // " +
+                     std::to_string(b * instructions_per_kernel + i));
+    }
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    c.kernels.push_back("_Z6kernelILi" + std::to_string(i) + "EEvPfS0_");
+    c.body_of[c.kernels.back()] = i % distinct_bodies;
+  }
+  return c;
+}
+
+// Stand-in for walking a kernel's basic blocks in kernelDB
+maestro::kernel_isa_fn synthetic_isa(const corpus& c) {
+  return [&c](const std::string& kernel, std::vector<std::string_view>& isa) {
+    for (const auto& instruction : c.bodies[c.body_of.at(kernel)]) {
+      isa.emplace_back(instruction);
+    }
+    return true;
+  };
+}
+
+// One DOM for every kernel and a single dump: the old loop without its
+// per-kernel rewrites of the file
+void BM_dump_serial_dom(benchmark::State& state) {
+  const auto c = make_corpus(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    nlohmann::json json;
+    for (const auto& kernel : c.kernels) {
+      nlohmann::json assembly = nlohmann::json::array();
+      for (auto instruction : c.bodies[c.body_of.at(kernel)]) {
+        std::erase(instruction, '\t');
+        assembly.push_back(instruction);
+      }
+      json["kernels"][kernel]["assembly"] = std::move(assembly);
+      json["kernels"][kernel]["signature"] = kernel;
+    }
+    benchmark::DoNotOptimize(json.dump(4));
+  }
+  state.SetItemsProcessed(state.iterations() * c.kernels.size());
+}
+BENCHMARK(BM_dump_serial_dom)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMillisecond);
+
+// range(1) selects NEXUS_SHARED_ISA
+void BM_dump_parallel(benchmark::State& state) {
+  const auto c = make_corpus(static_cast<std::size_t>(state.range(0)));
+  const auto isa = synthetic_isa(c);
+  const auto threads = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    maestro::isa_store store;
+    const auto document =
+        maestro::render_kernel_dump(c.kernels, isa, store, threads, state.range(1));
+    bytes = document.size();
+    benchmark::DoNotOptimize(document.data());
+  }
+  state.SetItemsProcessed(state.iterations() * c.kernels.size());
+  state.counters["bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_dump_parallel)
+    ->ArgsProduct({{100, 1000, 10000, 50000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "line_table.hpp"
+
+namespace {
+
+// Enough of kernelDB's instruction_t to make copies cost what they do there
+struct instruction {
+  std::string disassembly;
+  std::vector<std::string> operands;
+  std::uint32_t line;
+  std::uint32_t path_id;
+};
+
+struct kernel {
+  std::vector<instruction> instructions;
+  std::vector<std::string> paths;
+  // What getKernelLines and getInstructionsForLine are served from
+  std::map<std::uint32_t, std::vector<instruction>> by_line;
+};
+
+// Inlined code spreads a kernel over a few files and interleaves their lines
+kernel make_kernel(std::size_t num_instructions) {
+  kernel k;
+  k.paths = {"/workspace/src/vector_add.hip",
+             "/opt/rocm/include/hip/amd_detail/amd_hip_runtime.h",
+             "/workspace/src/common.hpp"};
+  for (std::size_t i = 0; i < num_instructions; i++) {
+    instruction inst{"v_add_f32_e32 v" + std::to_string(i % 64) + ", v1, v2",
+                     {"v" + std::to_string(i % 64), "v1", "v2"},
+                     static_cast<std::uint32_t>(i % 7 == 0 ? 0 : 20 + (i / 3) % 200),
+                     static_cast<std::uint32_t>(i % 3)};
+    k.instructions.push_back(inst);
+    if (inst.line) {
+      k.by_line[inst.line].push_back(inst);
+    }
+  }
+  return k;
+}
+
+void BM_lines_per_line_lookup(benchmark::State& state) {
+  const auto k = make_kernel(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::vector<std::uint32_t> lines;
+    for (const auto& [line, instructions] : k.by_line) {
+      lines.push_back(line);
+    }
+    std::set<std::pair<std::string, std::uint32_t>> seen_lines;
+    std::vector<std::uint32_t> out_lines;
+    std::vector<std::string> out_files;
+    for (const auto line : lines) {
+      const auto instructions = k.by_line.at(line);
+      for (const auto& inst : instructions) {
+        const auto& filename = k.paths[inst.path_id];
+        std::pair<std::string, std::uint32_t> key = {filename, line};
+        if (seen_lines.count(key)) {
+          continue;
+        }
+        seen_lines.insert(key);
+        out_lines.push_back(line);
+        out_files.push_back(filename);
+      }
+    }
+    benchmark::DoNotOptimize(out_files.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lines_per_line_lookup)->RangeMultiplier(8)->Range(512, 32768);
+
+void BM_lines_single_pass(benchmark::State& state) {
+  const auto k = make_kernel(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    maestro::line_table table;
+    std::vector<std::int64_t> path_files;
+    for (const auto& inst : k.instructions) {
+      std::uint32_t file = 0;
+      if (inst.line) {
+        if (inst.path_id >= path_files.size()) {
+          path_files.resize(inst.path_id + 1, -1);
+        }
+        if (path_files[inst.path_id] < 0) {
+          path_files[inst.path_id] = table.add_file(k.paths[inst.path_id]);
+        }
+        file = static_cast<std::uint32_t>(path_files[inst.path_id]);
+      }
+      table.add(file, inst.line);
+    }
+    table.finish();
+    benchmark::DoNotOptimize(table.source_index().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lines_single_pass)->RangeMultiplier(8)->Range(512, 32768);
+
+}  // namespace
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+// Compile LOG_DETAIL out in this file; run with NEXUS_LOG_LEVEL unset so the
+// remaining levels are disabled at runtime.
+#define NEXUS_MIN_LOG_LEVEL 3
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#include "log.hpp"
+
+namespace {
+
+struct packet {
+  std::uint16_t header;
+  std::uint16_t setup;
+  std::uint16_t workgroup_size[3];
+  std::uint32_t grid_size[3];
+  std::uint64_t kernel_object;
+  std::uint64_t kernarg_address;
+};
+
+// Same shape as packet_to_text in nexus.cpp.
+std::string packet_to_text(const packet& p) {
+  std::ostringstream oss;
+  oss << "header: " << p.header << ", setup: " << p.setup << ", workgroup_size: ["
+      << p.workgroup_size[0] << ", " << p.workgroup_size[1] << ", "
+      << p.workgroup_size[2] << "], grid_size: [" << p.grid_size[0] << ", "
+      << p.grid_size[1] << ", " << p.grid_size[2] << "], kernel_object: 0x"
+      << std::hex << p.kernel_object << ", kernarg_address: 0x"
+      << p.kernarg_address;
+  return oss.str();
+}
+
+const packet sample{0x1502,
+                    3,
+                    {256, 1, 1},
+                    {1 << 20, 1, 1},
+                    0x7f0012345600,
+                    0x7f00abc000};
+
+// What every call site used to pay with logging off: the relative path and the
+// arguments were computed before the level was checked.
+void BM_disabled_eager(benchmark::State& state) {
+  for (auto _ : state) {
+    const auto file = std::filesystem::relative(
+        __FILE__, std::filesystem::path(__FILE__).parent_path().parent_path());
+    const auto text = packet_to_text(sample);
+    if (maestro::detail::log_enabled(maestro::detail::LogLevel::DETAIL)) {
+      maestro::detail::log_message(0,
+                                   maestro::detail::LogLevel::DETAIL,
+                                   file.c_str(),
+                                   __LINE__,
+                                   "Executing packet: {}",
+                                   text);
+    }
+    benchmark::DoNotOptimize(text);
+  }
+}
+BENCHMARK(BM_disabled_eager);
+
+void BM_disabled_runtime(benchmark::State& state) {
+  for (auto _ : state) {
+    LOG_ERROR("Executing packet: {}", packet_to_text(sample));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_disabled_runtime);
+
+void BM_disabled_compiled_out(benchmark::State& state) {
+  for (auto _ : state) {
+    LOG_DETAIL("Executing packet: {}", packet_to_text(sample));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_disabled_compiled_out);
+
+}  // namespace
@@ -0,0 +1,75 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "packet_batch.hpp"
+
+namespace {
+
+// Synthetic AQL slots: mostly kernel dispatches with barrier-AND packets
+// mixed in, as in a typical HIP stream.
+std::vector<unsigned char> make_batch(std::size_t count) {
+  std::vector<unsigned char> slots(count * maestro::aql_packet_size);
+  std::mt19937 rng(42);
+  for (std::size_t i = 0; i < count; i++) {
+    const std::uint16_t type = rng() % 4 == 0 ? 3 : maestro::aql_kernel_dispatch_type;
+    const std::uint16_t header = type | (1 << 8) | (2 << 9) | (2 << 11);
+    std::memcpy(&slots[i * maestro::aql_packet_size], &header, sizeof(header));
+  }
+  return slots;
+}
+
+template <std::size_t (*Classify)(const void*, std::size_t, std::uint32_t*)>
+void BM_classify(benchmark::State& state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto slots = make_batch(count);
+  std::vector<std::uint32_t> dispatches(count);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Classify(slots.data(), count, dispatches.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Only the first packet of every batch, as write_packets used to look at
+std::size_t first_only(const void* packets, std::size_t, std::uint32_t* out) {
+  out[0] = 0;
+  return *static_cast<const unsigned char*>(packets) == maestro::aql_kernel_dispatch_type;
+}
+
+BENCHMARK(BM_classify<first_only>)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_classify<maestro::detail::find_dispatches_scalar>)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK(BM_classify<maestro::detail::find_dispatches_avx2>)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK(BM_classify<maestro::find_dispatches>)->RangeMultiplier(4)->Range(1, 256);
+
+}  // namespace
@@ -0,0 +1,80 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "staging_pool.hpp"
+
+namespace {
+
+// Stand-in for pinned host allocations: fresh pages faulted in up front
+bool map_pages(void*, std::size_t size, void** ptr) {
+  *ptr = mmap(nullptr,
+              size,
+              PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+              -1,
+              0);
+  return *ptr != MAP_FAILED;
+}
+
+void unmap_pages(void* context, void* ptr) {
+  munmap(ptr, reinterpret_cast<std::size_t>(context));
+}
+
+// The previous memcpy_d2h: allocate, copy, free on every call
+void BM_copy_fresh_buffer(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<unsigned char> device(size, 1);
+  for (auto _ : state) {
+    void* host = nullptr;
+    map_pages(nullptr, size, &host);
+    std::memcpy(host, device.data(), size);
+    benchmark::DoNotOptimize(host);
+    munmap(host, size);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_copy_fresh_buffer)->RangeMultiplier(16)->Range(4 << 10, 16 << 20);
+
+void BM_copy_staging_pool(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<unsigned char> device(size, 1);
+  // Sizes are powers of two, so the size is the buffer capacity
+  maestro::staging_pool pool(
+      {map_pages, unmap_pages, reinterpret_cast<void*>(size)}, 64 << 20);
+  for (auto _ : state) {
+    auto host = pool.acquire(size);
+    std::memcpy(host.data(), device.data(), size);
+    benchmark::DoNotOptimize(host.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_copy_staging_pool)->RangeMultiplier(16)->Range(4 << 10, 16 << 20);
+
+}  // namespace
@@ -0,0 +1,90 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trace_format.hpp"
+
+namespace {
+
+// A kernel of n source lines over a few files with 8 instructions per line;
+// ISA text repeats across kernels as it does in real code objects.
+maestro::kernel_record make_record(std::size_t index, std::size_t num_lines) {
+  // Records view their ISA, as they view an isa_store in nexus
+  static const std::vector<std::string> isa = [] {
+    std::vector<std::string> text;
+    for (std::size_t i = 0; i < 32; i++) {
+      text.push_back("v_add_f32_e32 v" + std::to_string(i) + ", v1, v2");
+    }
+    return text;
+  }();
+  maestro::kernel_record record;
+  record.name = "_Z10vector_addILi" + std::to_string(index) + "EEvPfS0_S0_";
+  record.signature = record.name;
+  for (std::size_t i = 0; i < num_lines; i++) {
+    record.lines.push_back(static_cast<std::uint32_t>(40 + i));
+    record.files.push_back("/workspace/kernels/vector_add_" + std::to_string(i % 4) +
+                           ".hip");
+    record.hip.push_back("  c[idx] = a[idx] + b[idx]; // " + std::to_string(i));
+    for (std::size_t j = 0; j < 8; j++) {
+      record.assembly.push_back(isa[(i + j) % 32]);
+    }
+  }
+  return record;
+}
+
+void BM_write_ndjson(benchmark::State& state) {
+  const auto record = make_record(0, static_cast<std::size_t>(state.range(0)));
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    nlohmann::json line;
+    line["kernel"] = record.name;
+    line["record"] = maestro::to_json(record);
+    const auto text = line.dump() + "\n";
+    bytes += text.size();
+    benchmark::DoNotOptimize(text.data());
+  }
+  state.counters["bytes_per_kernel"] = static_cast<double>(bytes) / state.iterations();
+}
+BENCHMARK(BM_write_ndjson)->Arg(16)->Arg(256);
+
+void BM_write_binary(benchmark::State& state) {
+  const auto record = make_record(0, static_cast<std::size_t>(state.range(0)));
+  maestro::nxb_encoder encoder;
+  std::string out;
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    out.clear();
+    encoder.encode(record, out);
+    bytes += out.size();
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.counters["bytes_per_kernel"] = static_cast<double>(bytes) / state.iterations();
+}
+BENCHMARK(BM_write_binary)->Arg(16)->Arg(256);
+
+}  // namespace
@@ -0,0 +1,200 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "allocation_registry.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace maestro {
+
+namespace {
+
+// concurrent_map keys must be non-zero
+std::uint64_t pool_key(std::uint64_t pool, allocation_source source) {
+  const std::uint64_t key = (pool << 1) | (source == allocation_source::REGION);
+  return key ? key : ~0ULL;
+}
+
+}  // namespace
+
+template <typename F>
+void allocation_registry::for_each_region(const allocation& a, F&& f) {
+  const auto last = a.size ? a.base + a.size - 1 : a.base;
+  for (auto region = a.base >> region_bits; region <= last >> region_bits; region++) {
+    f(shards_[shard_index(region)]);
+  }
+}
+
+allocation_registry::pool_stats& allocation_registry::stats_for(
+    std::uint64_t pool,
+    allocation_source source) {
+  const auto key = pool_key(pool, source);
+  if (auto* stats = pools_index_.find(key)) {
+    return *stats;
+  }
+  std::lock_guard g(pools_mutex_);
+  if (auto* stats = pools_index_.find(key)) {
+    return *stats;
+  }
+  auto& stats = *pools_.emplace_back(std::make_unique<pool_stats>());
+  stats.pool = pool;
+  stats.source = source;
+  pools_index_.insert(key, &stats);
+  return stats;
+}
+
+void allocation_registry::add(std::uint64_t base,
+                              std::uint64_t size,
+                              std::uint64_t pool,
+                              allocation_source source) {
+  // A base handed out again means its free went through a path we do not see
+  remove(base);
+
+  const allocation a{base, size, pool, source};
+  for_each_region(a, [&a](shard& s) {
+    std::unique_lock lock(s.mutex);
+    s.allocations.insert_or_assign(a.base, a);
+  });
+  live_.fetch_add(1, std::memory_order_relaxed);
+
+  auto lowest = lowest_.load(std::memory_order_relaxed);
+  while (base < lowest &&
+         !lowest_.compare_exchange_weak(lowest, base, std::memory_order_relaxed)) {
+  }
+  auto highest = highest_.load(std::memory_order_relaxed);
+  while (base + size > highest && !highest_.compare_exchange_weak(
+                                      highest, base + size, std::memory_order_relaxed)) {
+  }
+
+  auto& stats = stats_for(pool, source);
+  const auto live = stats.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  auto peak = stats.peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !stats.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  stats.live_allocations.fetch_add(1, std::memory_order_relaxed);
+  stats.allocations.fetch_add(1, std::memory_order_relaxed);
+  stats.size_histogram[std::bit_width(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::optional<allocation> allocation_registry::remove(std::uint64_t base) {
+  std::optional<allocation> removed;
+  {
+    auto& s = shards_[shard_index(base >> region_bits)];
+    std::unique_lock lock(s.mutex);
+    auto it = s.allocations.find(base);
+    if (it == s.allocations.end()) {
+      return std::nullopt;
+    }
+    removed = it->second;
+    s.allocations.erase(it);
+  }
+  // Entries in the other regions of a boundary-crossing allocation
+  for_each_region(*removed, [base](shard& s) {
+    std::unique_lock lock(s.mutex);
+    s.allocations.erase(base);
+  });
+  live_.fetch_sub(1, std::memory_order_relaxed);
+
+  auto& stats = stats_for(removed->pool, removed->source);
+  stats.live_bytes.fetch_sub(removed->size, std::memory_order_relaxed);
+  stats.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+  stats.frees.fetch_add(1, std::memory_order_relaxed);
+  return removed;
+}
+
+std::optional<allocation> allocation_registry::find_locked(const shard& s,
+                                                          std::uint64_t address) {
+  auto it = s.allocations.upper_bound(address);
+  if (it == s.allocations.begin()) {
+    return std::nullopt;
+  }
+  --it;
+  const auto& a = it->second;
+  // Several regions can share a shard, so the predecessor may be far away
+  if (address - a.base >= std::max<std::uint64_t>(a.size, 1)) {
+    return std::nullopt;
+  }
+  return a;
+}
+
+std::optional<allocation> allocation_registry::find(std::uint64_t address) const {
+  const auto& s = shards_[shard_index(address >> region_bits)];
+  std::shared_lock lock(s.mutex);
+  return find_locked(s, address);
+}
+
+std::size_t allocation_registry::find_many(const std::uint64_t* addresses,
+                                           std::size_t count,
+                                           std::optional<allocation>* out) const {
+  const auto lowest = lowest_.load(std::memory_order_relaxed);
+  const auto highest = highest_.load(std::memory_order_relaxed);
+
+  // (shard, index) of every address that could be inside an allocation
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> order;
+  order.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    out[i].reset();
+    if (addresses[i] >= lowest && addresses[i] < highest) {
+      order.emplace_back(shard_index(addresses[i] >> region_bits), i);
+    }
+  }
+  std::sort(order.begin(), order.end());
+
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < order.size();) {
+    const auto& s = shards_[order[i].first];
+    std::shared_lock lock(s.mutex);
+    for (const auto shard = order[i].first; i < order.size() && order[i].first == shard;
+         i++) {
+      out[order[i].second] = find_locked(s, addresses[order[i].second]);
+      found += out[order[i].second].has_value();
+    }
+  }
+  return found;
+}
+
+std::vector<pool_usage> allocation_registry::usage() const {
+  std::lock_guard g(pools_mutex_);
+  std::vector<pool_usage> result;
+  result.reserve(pools_.size());
+  for (const auto& stats : pools_) {
+    pool_usage u{};
+    u.pool = stats->pool;
+    u.source = stats->source;
+    u.live_bytes = stats->live_bytes.load(std::memory_order_relaxed);
+    u.peak_bytes = stats->peak_bytes.load(std::memory_order_relaxed);
+    u.live_allocations = stats->live_allocations.load(std::memory_order_relaxed);
+    u.allocations = stats->allocations.load(std::memory_order_relaxed);
+    u.frees = stats->frees.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < allocation_size_buckets; i++) {
+      u.size_histogram[i] = stats->size_histogram[i].load(std::memory_order_relaxed);
+    }
+    result.push_back(u);
+  }
+  return result;
+}
+
+}  // namespace maestro
@@ -0,0 +1,137 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+#include "concurrent_map.hpp"
+
+namespace maestro {
+
+enum struct allocation_source {
+  REGION,       // hsa_memory_allocate
+  MEMORY_POOL,  // hsa_amd_memory_pool_allocate
+};
+
+struct allocation {
+  std::uint64_t base;
+  std::uint64_t size;
+  std::uint64_t pool;
+  allocation_source source;
+};
+
+// Bucket i counts allocations of [2^(i-1), 2^i) bytes; bucket 0 is empty ones
+inline constexpr std::size_t allocation_size_buckets = 65;
+
+struct pool_usage {
+  std::uint64_t pool;
+  allocation_source source;
+  std::uint64_t live_bytes;
+  std::uint64_t peak_bytes;
+  std::uint64_t live_allocations;
+  std::uint64_t allocations;
+  std::uint64_t frees;
+  std::array<std::uint64_t, allocation_size_buckets> size_histogram;
+};
+
+// Live device and host allocations made through HSA, with per-pool usage.
+// Allocations are sharded by 4 GiB address region, each shard an ordered map
+// under its own lock, so allocations on different regions do not contend and
+// find() is a map lookup in a single shard. An allocation crossing a region
+// boundary is entered in every region it covers.
+class allocation_registry {
+ public:
+  void add(std::uint64_t base,
+           std::uint64_t size,
+           std::uint64_t pool,
+           allocation_source source);
+
+  // Forgets the allocation starting at base; nullopt if it is not known
+  std::optional<allocation> remove(std::uint64_t base);
+
+  // The allocation containing address, if any
+  std::optional<allocation> find(std::uint64_t address) const;
+
+  // find() over a batch, taking each shard's lock once. out[i] is the
+  // allocation containing addresses[i]. Returns how many were found.
+  std::size_t find_many(const std::uint64_t* addresses,
+                        std::size_t count,
+                        std::optional<allocation>* out) const;
+
+  std::size_t size() const { return live_.load(std::memory_order_relaxed); }
+
+  std::vector<pool_usage> usage() const;
+
+ private:
+  static constexpr unsigned region_bits = 32;
+  static constexpr std::size_t num_shards = 64;
+
+  struct alignas(64) shard {
+    mutable std::shared_mutex mutex;
+    std::map<std::uint64_t, allocation> allocations;
+  };
+
+  struct pool_stats {
+    std::uint64_t pool;
+    allocation_source source;
+    std::atomic<std::uint64_t> live_bytes{0};
+    std::atomic<std::uint64_t> peak_bytes{0};
+    std::atomic<std::uint64_t> live_allocations{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> frees{0};
+    std::array<std::atomic<std::uint64_t>, allocation_size_buckets> size_histogram{};
+  };
+
+  static std::size_t shard_index(std::uint64_t region) {
+    return static_cast<std::size_t>((region * 0x9e3779b97f4a7c15ULL) >> 58);
+  }
+  template <typename F>
+  void for_each_region(const allocation& a, F&& f);
+
+  pool_stats& stats_for(std::uint64_t pool, allocation_source source);
+
+  static std::optional<allocation> find_locked(const shard& s, std::uint64_t address);
+
+  std::array<shard, num_shards> shards_;
+  std::atomic<std::size_t> live_{0};
+  // Bounds of every address ever registered, to reject non-pointers early
+  std::atomic<std::uint64_t> lowest_{UINT64_MAX};
+  std::atomic<std::uint64_t> highest_{0};
+
+  // Pools are few and looked up on every allocation
+  mutable std::mutex pools_mutex_;
+  std::vector<std::unique_ptr<pool_stats>> pools_;
+  concurrent_map<pool_stats> pools_index_;
+};
+
+}  // namespace maestro
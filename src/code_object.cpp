@@ -0,0 +1,443 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "code_object.hpp"
+
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "log.hpp"
+
+namespace maestro {
+
+namespace {
+
+// NT_AMDGPU_METADATA, the msgpack note of code object v3 and later
+constexpr std::uint32_t amdgpu_metadata_note = 32;
+
+// Just enough msgpack to walk the AMDGPU metadata. Any truncated or malformed
+// input clears ok() and makes every later read return INVALID.
+class msgpack_reader {
+ public:
+  enum struct kind { INVALID, NIL, BOOL, UINT, INT, FLOAT, STR, BIN, EXT, ARRAY, MAP };
+
+  struct item {
+    kind type;
+    std::uint64_t value;  // scalar value, payload bytes, or element count
+  };
+
+  msgpack_reader(const std::uint8_t* data, std::size_t size)
+      : p_(data), end_(data + size) {}
+
+  bool ok() const { return ok_; }
+
+  // Reads a header; STR, BIN and EXT payloads must then be take()n or skipped
+  item next() {
+    if (!ok_ || p_ == end_) {
+      ok_ = false;
+      return {kind::INVALID, 0};
+    }
+    const std::uint8_t b = *p_++;
+    if (b <= 0x7f) {
+      return {kind::UINT, b};
+    }
+    if (b >= 0xe0) {
+      return {kind::INT, static_cast<std::uint64_t>(static_cast<std::int8_t>(b))};
+    }
+    switch (b & 0xf0) {
+      case 0x80:
+        return {kind::MAP, b & 0x0fu};
+      case 0x90:
+        return {kind::ARRAY, b & 0x0fu};
+      case 0xa0:
+      case 0xb0:
+        return {kind::STR, b & 0x1fu};
+    }
+    switch (b) {
+      case 0xc0:
+        return {kind::NIL, 0};
+      case 0xc2:
+      case 0xc3:
+        return {kind::BOOL, b & 1u};
+      case 0xc4:
+      case 0xc5:
+      case 0xc6:
+        return {kind::BIN, read_be(1u << (b - 0xc4))};
+      case 0xc7:
+      case 0xc8:
+      case 0xc9:
+        // The extension type byte is part of the payload
+        return {kind::EXT, read_be(1u << (b - 0xc7)) + 1};
+      case 0xca:
+        return {kind::FLOAT, read_be(4)};
+      case 0xcb:
+        return {kind::FLOAT, read_be(8)};
+      case 0xcc:
+      case 0xcd:
+      case 0xce:
+      case 0xcf:
+        return {kind::UINT, read_be(1u << (b - 0xcc))};
+      case 0xd0:
+      case 0xd1:
+      case 0xd2:
+      case 0xd3:
+        return {kind::INT, read_be(1u << (b - 0xd0))};
+      case 0xd4:
+      case 0xd5:
+      case 0xd6:
+      case 0xd7:
+      case 0xd8:
+        return {kind::EXT, (1u << (b - 0xd4)) + 1};
+      case 0xd9:
+      case 0xda:
+      case 0xdb:
+        return {kind::STR, read_be(1u << (b - 0xd9))};
+      case 0xdc:
+      case 0xdd:
+        return {kind::ARRAY, read_be(2u << (b - 0xdc))};
+      case 0xde:
+      case 0xdf:
+        return {kind::MAP, read_be(2u << (b - 0xde))};
+    }
+    ok_ = false;
+    return {kind::INVALID, 0};
+  }
+
+  std::string_view take(std::uint64_t size) {
+    if (!ok_ || static_cast<std::uint64_t>(end_ - p_) < size) {
+      ok_ = false;
+      return {};
+    }
+    const std::string_view bytes(reinterpret_cast<const char*>(p_), size);
+    p_ += size;
+    return bytes;
+  }
+
+  // Reads a string, skipping whatever else is there instead
+  std::string_view string() {
+    const auto header = next();
+    if (header.type == kind::STR) {
+      return take(header.value);
+    }
+    skip(header);
+    return {};
+  }
+
+  // Reads an unsigned integer, skipping whatever else is there instead
+  std::uint64_t uint() {
+    const auto header = next();
+    if (header.type == kind::UINT) {
+      return header.value;
+    }
+    skip(header);
+    return 0;
+  }
+
+  void skip(const item& header, int depth = 0) {
+    switch (header.type) {
+      case kind::STR:
+      case kind::BIN:
+      case kind::EXT:
+        take(header.value);
+        break;
+      case kind::ARRAY:
+      case kind::MAP: {
+        // Bounds the recursion on hostile input
+        if (depth > 32) {
+          ok_ = false;
+          break;
+        }
+        const auto count = header.type == kind::MAP ? 2 * header.value : header.value;
+        for (std::uint64_t i = 0; i < count && ok_; i++) {
+          skip(next(), depth + 1);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+ private:
+  std::uint64_t read_be(std::size_t size) {
+    std::uint64_t value = 0;
+    for (const auto byte : take(size)) {
+      value = (value << 8) | static_cast<std::uint8_t>(byte);
+    }
+    return value;
+  }
+
+  const std::uint8_t* p_;
+  const std::uint8_t* end_;
+  bool ok_{true};
+};
+
+// One entry of "amdhsa.kernels": ".name", ".symbol" and the ".args" list
+void read_kernel(msgpack_reader& reader,
+                 std::unordered_map<std::string, std::uint32_t>& sizes) {
+  const auto kernel = reader.next();
+  if (kernel.type != msgpack_reader::kind::MAP) {
+    reader.skip(kernel);
+    return;
+  }
+
+  std::string_view name;
+  std::string_view symbol;
+  std::uint64_t explicit_size = 0;
+  for (std::uint64_t i = 0; i < kernel.value && reader.ok(); i++) {
+    const auto key = reader.string();
+    if (key == ".name") {
+      name = reader.string();
+    } else if (key == ".symbol") {
+      symbol = reader.string();
+    } else if (key == ".args") {
+      const auto args = reader.next();
+      if (args.type != msgpack_reader::kind::ARRAY) {
+        reader.skip(args);
+        continue;
+      }
+      for (std::uint64_t a = 0; a < args.value && reader.ok(); a++) {
+        const auto arg = reader.next();
+        if (arg.type != msgpack_reader::kind::MAP) {
+          reader.skip(arg);
+          continue;
+        }
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        std::string_view value_kind;
+        for (std::uint64_t f = 0; f < arg.value && reader.ok(); f++) {
+          const auto field = reader.string();
+          if (field == ".offset") {
+            offset = reader.uint();
+          } else if (field == ".size") {
+            size = reader.uint();
+          } else if (field == ".value_kind") {
+            value_kind = reader.string();
+          } else {
+            reader.skip(reader.next());
+          }
+        }
+        if (!value_kind.starts_with("hidden_")) {
+          explicit_size = std::max(explicit_size, offset + size);
+        }
+      }
+    } else {
+      reader.skip(reader.next());
+    }
+  }
+
+  if (!reader.ok() || explicit_size > UINT32_MAX) {
+    return;
+  }
+  const auto bytes = static_cast<std::uint32_t>(explicit_size);
+  if (!name.empty()) {
+    sizes[std::string(name)] = bytes;
+  }
+  if (!symbol.empty()) {
+    sizes[std::string(symbol)] = bytes;
+  }
+}
+
+void read_metadata(const std::uint8_t* data,
+                   std::size_t size,
+                   std::unordered_map<std::string, std::uint32_t>& sizes) {
+  msgpack_reader reader(data, size);
+  const auto root = reader.next();
+  if (root.type != msgpack_reader::kind::MAP) {
+    return;
+  }
+  for (std::uint64_t i = 0; i < root.value && reader.ok(); i++) {
+    if (reader.string() != "amdhsa.kernels") {
+      reader.skip(reader.next());
+      continue;
+    }
+    const auto kernels = reader.next();
+    if (kernels.type != msgpack_reader::kind::ARRAY) {
+      reader.skip(kernels);
+      continue;
+    }
+    for (std::uint64_t k = 0; k < kernels.value && reader.ok(); k++) {
+      read_kernel(reader, sizes);
+    }
+  }
+}
+
+}  // namespace
+
+std::unordered_map<std::string, std::uint32_t> explicit_kernarg_sizes(const void* data,
+                                                                      std::size_t size) {
+  std::unordered_map<std::string, std::uint32_t> sizes;
+  const auto* bytes = static_cast<const std::uint8_t*>(data);
+
+  Elf64_Ehdr header;
+  if (size < sizeof(header)) {
+    return sizes;
+  }
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 ||
+      header.e_ident[EI_CLASS] != ELFCLASS64 ||
+      header.e_shentsize != sizeof(Elf64_Shdr) || header.e_shoff > size ||
+      header.e_shnum > (size - header.e_shoff) / sizeof(Elf64_Shdr)) {
+    return sizes;
+  }
+
+  for (std::uint16_t i = 0; i < header.e_shnum; i++) {
+    Elf64_Shdr section;
+    std::memcpy(&section, bytes + header.e_shoff + i * sizeof(section), sizeof(section));
+    if (section.sh_type != SHT_NOTE || section.sh_offset > size ||
+        section.sh_size > size - section.sh_offset) {
+      continue;
+    }
+
+    // Notes are 4-byte aligned: header, name, then descriptor
+    const auto align = [](std::uint64_t n) { return (n + 3) & ~std::uint64_t{3}; };
+    std::uint64_t offset = 0;
+    while (offset + sizeof(Elf64_Nhdr) <= section.sh_size) {
+      Elf64_Nhdr note;
+      std::memcpy(&note, bytes + section.sh_offset + offset, sizeof(note));
+      const auto name_offset = offset + sizeof(note);
+      const auto desc_offset = name_offset + align(note.n_namesz);
+      const auto next = desc_offset + align(note.n_descsz);
+      if (next > section.sh_size) {
+        break;
+      }
+      const std::string_view name(
+          reinterpret_cast<const char*>(bytes + section.sh_offset + name_offset),
+          note.n_namesz);
+      if (note.n_type == amdgpu_metadata_note && name == std::string_view("AMDGPU", 7)) {
+        read_metadata(bytes + section.sh_offset + desc_offset, note.n_descsz, sizes);
+      }
+      offset = next;
+    }
+  }
+  return sizes;
+}
+
+std::optional<std::string> file_identity(const std::string& path) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return std::nullopt;
+  }
+  return fmt::format("{}:{}:{}:{}.{}:{}",
+                     path,
+                     st.st_dev,
+                     st.st_ino,
+                     st.st_mtim.tv_sec,
+                     st.st_mtim.tv_nsec,
+                     st.st_size);
+}
+
+static bool write_all(int fd, const char* data, std::size_t size) {
+  while (size > 0) {
+    const auto written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+static std::atomic<std::size_t> live_memfds{0};
+
+std::size_t staged_code_object::open_memfds() {
+  return live_memfds.load(std::memory_order_relaxed);
+}
+
+std::optional<staged_code_object> staged_code_object::stage(
+    const void* data,
+    std::size_t size,
+    const code_object_hash& hash,
+    staging mode) {
+  static const std::size_t max_fds = [] {
+    const char* env = std::getenv("NEXUS_STAGING_MAX_FDS");
+    return env ? static_cast<std::size_t>(std::atoi(env)) : 256;
+  }();
+  const auto name = "nexus_code_object_" + hash.to_string();
+
+  if (mode == staging::MEMFD && live_memfds.load(std::memory_order_relaxed) >= max_fds) {
+    LOG_DETAIL("{} memfds already open, staging {} in a temp file", max_fds, name);
+  } else if (mode == staging::MEMFD) {
+    const int fd = memfd_create(name.c_str(), MFD_CLOEXEC);
+    if (fd >= 0) {
+      if (write_all(fd, static_cast<const char*>(data), size)) {
+        live_memfds.fetch_add(1, std::memory_order_relaxed);
+        // /proc/<pid> rather than /proc/self so helper processes spawned while
+        // ingesting can open it too
+        return staged_code_object(fd, fmt::format("/proc/{}/fd/{}", getpid(), fd));
+      }
+      ::close(fd);
+    }
+    LOG_WARN("Failed to stage code object {} in memory, using a temp file", name);
+  }
+
+  const auto tmp = std::filesystem::temp_directory_path() / (name + ".hsaco");
+  std::ofstream temp_file_stream(tmp, std::ios::binary);
+  temp_file_stream.write(static_cast<const char*>(data),
+                         static_cast<std::streamsize>(size));
+  temp_file_stream.close();
+  if (!temp_file_stream) {
+    LOG_ERROR("Failed to write code object to {}", tmp.string());
+    return std::nullopt;
+  }
+  return staged_code_object(-1, tmp.string());
+}
+
+staged_code_object& staged_code_object::operator=(staged_code_object&& other) noexcept {
+  if (this != &other) {
+    close();
+    fd_ = other.fd_;
+    path_ = std::move(other.path_);
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+staged_code_object::~staged_code_object() {
+  close();
+}
+
+void staged_code_object::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+    live_memfds.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace maestro
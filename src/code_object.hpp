@@ -0,0 +1,178 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include <fmt/core.h>
+
+namespace maestro {
+
+// 128-bit XXH3 digest of a whole code object
+struct code_object_hash {
+  std::uint64_t high;
+  std::uint64_t low;
+
+  bool operator==(const code_object_hash&) const = default;
+
+  std::string to_string() const { return fmt::format("{:016x}{:016x}", high, low); }
+};
+
+struct code_object_hash_hasher {
+  std::size_t operator()(const code_object_hash& hash) const {
+    return static_cast<std::size_t>(hash.low);
+  }
+};
+
+inline code_object_hash hash_code_object(const void* data, std::size_t size) {
+  const XXH128_hash_t hash = XXH3_128bits(data, size);
+  return {hash.high64, hash.low64};
+}
+
+// Bytes of explicit kernel arguments per kernel, read from the AMDGPU
+// metadata note of a code object. Hidden arguments (hostcall buffer, heap,
+// queue pointer, ...) are laid out after them and are not counted. Keyed by
+// both the kernel name and its ".kd" descriptor symbol; empty when the code
+// object carries no msgpack metadata.
+std::unordered_map<std::string, std::uint32_t> explicit_kernarg_sizes(const void* data,
+                                                                      std::size_t size);
+
+// Where in-memory code objects are put so kernelDB can open them by path
+enum struct staging {
+  MEMFD,      // anonymous memory file, opened through /proc/<pid>/fd/<fd>
+  TEMP_FILE,  // nexus_code_object_<hash>.hsaco in the temp directory
+};
+
+inline staging parse_staging(const char* mode) {
+  return mode && std::string(mode) == "tmpfile" ? staging::TEMP_FILE : staging::MEMFD;
+}
+
+// An in-memory code object exposed under a path. kernelDB only ingests files,
+// so a memfd is the closest we get to handing it the buffer directly; falls
+// back to a temp file when memfd_create is unavailable, or once
+// NEXUS_STAGING_MAX_FDS (default 256) memfds are open so the application keeps
+// its file descriptors.
+class staged_code_object {
+ public:
+  static std::optional<staged_code_object> stage(const void* data,
+                                                 std::size_t size,
+                                                 const code_object_hash& hash,
+                                                 staging mode);
+
+  staged_code_object(staged_code_object&& other) noexcept
+      : fd_(other.fd_), path_(std::move(other.path_)) {
+    other.fd_ = -1;
+  }
+  staged_code_object& operator=(staged_code_object&& other) noexcept;
+  ~staged_code_object();
+
+  const std::string& path() const { return path_; }
+  bool in_memory() const { return fd_ >= 0; }
+
+  // memfds currently held by staged objects
+  static std::size_t open_memfds();
+
+ private:
+  staged_code_object(int fd, std::string path) : fd_(fd), path_(std::move(path)) {}
+  void close();
+
+  int fd_{-1};
+  std::string path_;
+};
+
+// Where kernelDB finds a code object, and whether it already has it
+struct code_object_location {
+  std::string path;
+  // Keeps in-memory objects alive until kernelDB has ingested them
+  std::optional<staged_code_object> staged;
+  bool ingested{false};
+
+  explicit code_object_location(std::string file) : path(std::move(file)) {}
+  explicit code_object_location(staged_code_object object)
+      : path(object.path()), staged(std::move(object)) {}
+};
+
+// Path, device, inode, mtime and size of a file, or nullopt when it cannot be
+// stat'ed (pseudo-paths such as "[anonymous mapping]", deleted files)
+std::optional<std::string> file_identity(const std::string& path);
+
+// Deduplicates code objects by content hash and backing file so identical
+// reloads share one location and are only ingested once.
+class code_object_registry {
+ public:
+  // Returns the location already registered for this content (or backing
+  // file), creating it with `make` the first time. `make` may return nullptr.
+  template <typename F>
+  std::shared_ptr<code_object_location> intern(const code_object_hash& hash,
+                                               const std::optional<std::string>& file,
+                                               F&& make) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = by_hash_.find(hash); it != by_hash_.end()) {
+      return it->second;
+    }
+
+    std::shared_ptr<code_object_location> location;
+    // Every code object of a fat binary maps back to the same file. Only real
+    // files are shared, and a file rewritten in place counts as a new one.
+    const auto identity = file ? file_identity(*file) : std::nullopt;
+    if (identity) {
+      auto& slot = by_file_[*identity];
+      if (!slot) {
+        slot = make();
+      }
+      location = slot;
+    } else {
+      location = make();
+    }
+    if (location) {
+      by_hash_.emplace(hash, location);
+    }
+    return location;
+  }
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return by_hash_.size();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<code_object_hash,
+                     std::shared_ptr<code_object_location>,
+                     code_object_hash_hasher>
+      by_hash_;
+  // Keyed by file_identity()
+  std::unordered_map<std::string, std::shared_ptr<code_object_location>> by_file_;
+};
+
+}  // namespace maestro
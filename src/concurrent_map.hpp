@@ -0,0 +1,172 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace maestro {
+
+// Map from non-zero 64-bit keys to stable pointers, for state that is written
+// rarely and read on every dispatch. find() is wait-free and never allocates;
+// writers must be serialized by the caller. Slots are open-addressed and
+// written value-first, key-last, so a reader sees either an empty slot or a
+// complete entry. erase() only clears the value, so a slot never changes key;
+// callers keep erased values alive for readers that may still hold them.
+// Rehashing publishes a new array; retired arrays are kept until the map is
+// destroyed since readers may still be probing them. Their total size is that
+// of the live array, plus one array per batch of erases.
+template <typename T>
+class concurrent_map {
+ public:
+  explicit concurrent_map(std::size_t initial_capacity = 1024) {
+    std::size_t capacity = 16;
+    while (capacity < initial_capacity) {
+      capacity <<= 1;
+    }
+    current_.store(allocate(capacity), std::memory_order_release);
+  }
+
+  T* find(std::uint64_t key) const {
+    const auto* t = current_.load(std::memory_order_acquire);
+    for (std::size_t i = hash(key) & t->mask;; i = (i + 1) & t->mask) {
+      const auto k = t->slots[i].key.load(std::memory_order_acquire);
+      if (k == key) {
+        return t->slots[i].value.load(std::memory_order_acquire);
+      }
+      if (k == 0) {
+        return nullptr;
+      }
+    }
+  }
+
+  // Inserts or replaces; callers serialize writers
+  void insert(std::uint64_t key, T* value) {
+    auto* t = current_.load(std::memory_order_relaxed);
+    const auto* existing = find_slot(*t, key);
+
+    // Keep the load factor under 1/2 so probe sequences stay short. Erased
+    // keys occupy their slot until the next rehash drops them; the table only
+    // grows when the live keys need it.
+    if (!existing && (used_ + 1) * 2 > t->mask + 1) {
+      auto capacity = t->mask + 1;
+      if ((size_ + 1) * 4 > capacity) {
+        capacity *= 2;
+      }
+      auto* rehashed = allocate(capacity);
+      for (std::size_t i = 0; i <= t->mask; i++) {
+        const auto k = t->slots[i].key.load(std::memory_order_relaxed);
+        auto* v = t->slots[i].value.load(std::memory_order_relaxed);
+        if (k != 0 && v) {
+          store(*rehashed, k, v);
+        }
+      }
+      used_ = size_;
+      t = rehashed;
+      current_.store(t, std::memory_order_release);
+    }
+
+    const bool live = existing && existing->value.load(std::memory_order_relaxed);
+    store(*t, key, value);
+    used_ += !existing;
+    size_ += !live;
+  }
+
+  // find() returns nullptr for the key from now on; same serialization as
+  // insert()
+  void erase(std::uint64_t key) {
+    auto* t = current_.load(std::memory_order_relaxed);
+    auto* existing = find_slot(*t, key);
+    if (existing && existing->value.load(std::memory_order_relaxed)) {
+      existing->value.store(nullptr, std::memory_order_release);
+      size_--;
+    }
+  }
+
+  // Number of keys with a value; same serialization as insert()
+  std::size_t size() const { return size_; }
+
+ private:
+  struct slot {
+    std::atomic<std::uint64_t> key{0};
+    std::atomic<T*> value{nullptr};
+  };
+  struct table {
+    std::size_t mask;
+    std::unique_ptr<slot[]> slots;
+  };
+
+  static std::size_t hash(std::uint64_t key) {
+    // Keys are mostly aligned addresses; mix the high bits down
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return static_cast<std::size_t>(key);
+  }
+
+  table* allocate(std::size_t capacity) {
+    auto t = std::make_unique<table>();
+    t->mask = capacity - 1;
+    t->slots = std::make_unique<slot[]>(capacity);
+    tables_.push_back(std::move(t));
+    return tables_.back().get();
+  }
+
+  static slot* find_slot(table& t, std::uint64_t key) {
+    for (std::size_t i = hash(key) & t.mask;; i = (i + 1) & t.mask) {
+      const auto k = t.slots[i].key.load(std::memory_order_relaxed);
+      if (k == key) {
+        return &t.slots[i];
+      }
+      if (k == 0) {
+        return nullptr;
+      }
+    }
+  }
+
+  static void store(table& t, std::uint64_t key, T* value) {
+    for (std::size_t i = hash(key) & t.mask;; i = (i + 1) & t.mask) {
+      const auto k = t.slots[i].key.load(std::memory_order_relaxed);
+      if (k == key) {
+        t.slots[i].value.store(value, std::memory_order_release);
+        return;
+      }
+      if (k == 0) {
+        t.slots[i].value.store(value, std::memory_order_relaxed);
+        t.slots[i].key.store(key, std::memory_order_release);
+        return;
+      }
+    }
+  }
+
+  std::atomic<table*> current_{nullptr};
+  std::vector<std::unique_ptr<table>> tables_;
+  std::size_t used_{0};  // slots taken, erased keys included
+  std::size_t size_{0};
+};
+
+}  // namespace maestro
@@ -0,0 +1,253 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace maestro {
+
+// A kernel dispatch as captured on the submit path and processed later by the
+// pipeline workers. Only what processing reads is kept, so ring slots stay
+// small.
+struct dispatch_record {
+  std::uint64_t kernel_object;
+};
+
+// Bounded lock-free ring (Vyukov's sequence-per-slot algorithm). Any number of
+// producers and consumers; push and pop never allocate.
+template <typename T>
+class mpmc_ring {
+ public:
+  explicit mpmc_ring(std::size_t capacity)
+      : mask_(round_up(capacity) - 1), slots_(new slot[mask_ + 1]) {
+    for (std::size_t i = 0; i <= mask_; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool try_push(const T& value) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      slot& s = slots_[pos & mask_];
+      const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          s.value = value;
+          s.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool try_pop(T& value) {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      slot& s = slots_[pos & mask_];
+      const std::size_t seq = s.sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          value = s.value;
+          s.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Approximate number of queued elements
+  std::size_t size() const {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    const auto head = head_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+ private:
+  static std::size_t round_up(std::size_t n) {
+    std::size_t result = 2;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  struct slot {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  static constexpr std::size_t cache_line = 64;
+
+  const std::size_t mask_;
+  std::unique_ptr<slot[]> slots_;
+  alignas(cache_line) std::atomic<std::size_t> tail_{0};
+  alignas(cache_line) std::atomic<std::size_t> head_{0};
+};
+
+// What the submit path does when the ring is full.
+enum struct backpressure {
+  DROP,    // discard the record
+  BLOCK,   // wait for a worker to make room
+  SAMPLE,  // past half capacity keep one record in `sample_rate`, drop when full
+};
+
+inline backpressure parse_backpressure(std::string_view mode) {
+  if (mode == "drop") {
+    return backpressure::DROP;
+  }
+  if (mode == "sample") {
+    return backpressure::SAMPLE;
+  }
+  return backpressure::BLOCK;
+}
+
+// Moves dispatch processing off the queue-intercept callback: submit() only
+// pushes a dispatch_record, background workers run the handler.
+class dispatch_pipeline {
+ public:
+  using handler_t = std::function<void(const dispatch_record&)>;
+
+  struct counters {
+    std::uint64_t submitted;
+    std::uint64_t dropped;
+    std::uint64_t sampled_out;
+    std::uint64_t processed;
+  };
+
+  dispatch_pipeline(handler_t handler,
+                    std::size_t capacity,
+                    std::size_t num_workers,
+                    backpressure mode,
+                    std::uint32_t sample_rate)
+      : handler_(std::move(handler)),
+        ring_(capacity),
+        mode_(mode),
+        sample_rate_(sample_rate ? sample_rate : 1) {
+    for (std::size_t i = 0; i < (num_workers ? num_workers : 1); i++) {
+      workers_.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ~dispatch_pipeline() { stop(); }
+
+  dispatch_pipeline(const dispatch_pipeline&) = delete;
+  dispatch_pipeline& operator=(const dispatch_pipeline&) = delete;
+
+  // Returns false when the record was dropped or sampled out.
+  bool submit(const dispatch_record& record) {
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    if (mode_ == backpressure::SAMPLE && ring_.size() > ring_.capacity() / 2 &&
+        sample_counter_.fetch_add(1, std::memory_order_relaxed) % sample_rate_ != 0) {
+      sampled_out_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    while (!ring_.try_push(record)) {
+      if (mode_ != backpressure::BLOCK || stopping_.load(std::memory_order_relaxed)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  // Drains the ring and joins the workers. Safe to call more than once.
+  void stop() {
+    if (stopping_.exchange(true)) {
+      return;
+    }
+    for (auto& worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  counters get_counters() const {
+    return {submitted_.load(std::memory_order_relaxed),
+            dropped_.load(std::memory_order_relaxed),
+            sampled_out_.load(std::memory_order_relaxed),
+            processed_.load(std::memory_order_relaxed)};
+  }
+
+ private:
+  void worker_loop() {
+    using namespace std::chrono_literals;
+    dispatch_record record;
+    auto idle = 0us;
+    for (;;) {
+      if (ring_.try_pop(record)) {
+        handler_(record);
+        processed_.fetch_add(1, std::memory_order_relaxed);
+        idle = 0us;
+        continue;
+      }
+      if (stopping_.load(std::memory_order_acquire)) {
+        return;
+      }
+      // Back off up to 1ms while idle so workers do not burn a core
+      idle = std::min(idle + 10us, std::chrono::microseconds(1000));
+      std::this_thread::sleep_for(idle);
+    }
+  }
+
+  handler_t handler_;
+  mpmc_ring<dispatch_record> ring_;
+  const backpressure mode_;
+  const std::uint32_t sample_rate_;
+  std::vector<std::thread> workers_;
+
+  std::atomic<bool> stopping_{false};
+  std::atomic<std::uint64_t> sample_counter_{0};
+  std::atomic<std::uint64_t> submitted_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> sampled_out_{0};
+  std::atomic<std::uint64_t> processed_{0};
+};
+
+}  // namespace maestro
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "dispatch_timer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace maestro {
+
+dispatch_timer::dispatch_timer(const dispatch_timer_api& api, std::size_t max_signals)
+    : api_(api),
+      slots_(new slot[max_signals]),
+      num_slots_(max_signals),
+      free_(max_signals),
+      completed_(max_signals) {
+  for (std::size_t i = 0; i < num_slots_; i++) {
+    slots_[i].timer = this;
+    slots_[i].index = static_cast<std::uint32_t>(i);
+    free_.try_push(static_cast<std::uint32_t>(i));
+  }
+  harvester_ = std::thread([this]() { run(); });
+}
+
+dispatch_timer::~dispatch_timer() {
+  stop();
+}
+
+std::optional<std::uint64_t> dispatch_timer::attach(std::uint64_t kernel_object,
+                                                    std::uint64_t agent,
+                                                    std::uint64_t app_signal) {
+  std::uint32_t index;
+  if (!free_.try_pop(index)) {
+    exhausted_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  // Signals are created on first use so short runs do not pay for the pool
+  slot& s = slots_[index];
+  if (s.signal == 0 && !api_.signal_create(&s.signal)) {
+    s.signal = 0;
+    free_.try_push(index);
+    exhausted_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  s.app_signal = app_signal;
+  s.kernel_object = kernel_object;
+  s.agent = agent;
+
+  if (!api_.on_completion(s.signal, &dispatch_timer::on_complete, &s)) {
+    free_.try_push(index);
+    failed_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  attached_.fetch_add(1, std::memory_order_relaxed);
+  return s.signal;
+}
+
+bool dispatch_timer::on_complete(std::int64_t, void* arg) {
+  // Runs on the runtime's signal thread: release the application first and
+  // leave the profiler query to the harvester
+  auto& s = *static_cast<slot*>(arg);
+  if (s.app_signal != 0) {
+    s.timer->api_.signal_forward(s.app_signal);
+  }
+  s.timer->completed_.try_push(s.index);
+  return false;
+}
+
+void dispatch_timer::harvest(slot& s) {
+  std::uint64_t start = 0;
+  std::uint64_t end = 0;
+  if (api_.dispatch_time(s.agent, s.signal, &start, &end) && end >= start) {
+    const auto duration = end - start;
+    std::lock_guard g(timings_mutex_);
+    auto& t = timings_[s.kernel_object];
+    t.dispatches++;
+    t.total_ns += duration;
+    t.min_ns = std::min(t.min_ns, duration);
+    t.max_ns = std::max(t.max_ns, duration);
+    t.first_start = std::min(t.first_start, start);
+    t.last_end = std::max(t.last_end, end);
+  } else {
+    failed_.fetch_add(1, std::memory_order_relaxed);
+  }
+  api_.signal_reset(s.signal);
+  completed_count_.fetch_add(1, std::memory_order_relaxed);
+  free_.try_push(s.index);
+}
+
+void dispatch_timer::run() {
+  auto backoff = std::chrono::microseconds(1);
+  while (!stop_.load(std::memory_order_acquire)) {
+    std::uint32_t index;
+    if (completed_.try_pop(index)) {
+      harvest(slots_[index]);
+      backoff = std::chrono::microseconds(1);
+      continue;
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+  }
+}
+
+void dispatch_timer::stop(std::chrono::milliseconds timeout) {
+  if (!harvester_.joinable()) {
+    return;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (completed_count_.load(std::memory_order_acquire) <
+             attached_.load(std::memory_order_acquire) &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stop_.store(true, std::memory_order_release);
+  harvester_.join();
+
+  std::uint32_t index;
+  while (completed_.try_pop(index)) {
+    harvest(slots_[index]);
+  }
+  // Signals still in flight belong to dispatches that never completed
+  while (free_.try_pop(index)) {
+    if (slots_[index].signal != 0) {
+      api_.signal_destroy(slots_[index].signal);
+      slots_[index].signal = 0;
+    }
+  }
+}
+
+std::unordered_map<std::uint64_t, kernel_timing> dispatch_timer::get_timings() const {
+  std::lock_guard g(timings_mutex_);
+  return timings_;
+}
+
+dispatch_timer::counters dispatch_timer::get_counters() const {
+  return {attached_.load(std::memory_order_relaxed),
+          completed_count_.load(std::memory_order_relaxed),
+          exhausted_.load(std::memory_order_relaxed),
+          failed_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace maestro
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+#include "dispatch_pipeline.hpp"
+
+namespace maestro {
+
+// Runtime entry points used by the timer. nexus fills them from the HSA API
+// tables; handles are the raw hsa_signal_t / hsa_agent_t values so the timer
+// can be driven by fakes.
+struct dispatch_timer_api {
+  using completion_handler = bool (*)(std::int64_t value, void* arg);
+
+  // Creates a signal with value 1
+  bool (*signal_create)(std::uint64_t* signal);
+  void (*signal_destroy)(std::uint64_t signal);
+  // Sets the signal back to 1 before it is reused
+  void (*signal_reset)(std::uint64_t signal);
+  // Decrements the application's own completion signal
+  void (*signal_forward)(std::uint64_t signal);
+  // Calls handler once the signal drops below 1
+  bool (*on_completion)(std::uint64_t signal, completion_handler handler, void* arg);
+  // Start and end of the dispatch that completed the signal, in ns
+  bool (*dispatch_time)(std::uint64_t agent,
+                        std::uint64_t signal,
+                        std::uint64_t* start,
+                        std::uint64_t* end);
+};
+
+struct kernel_timing {
+  std::uint64_t dispatches{0};
+  std::uint64_t total_ns{0};
+  std::uint64_t min_ns{UINT64_MAX};
+  std::uint64_t max_ns{0};
+  std::uint64_t first_start{UINT64_MAX};
+  std::uint64_t last_end{0};
+};
+
+// Times kernel dispatches with pooled completion signals. attach() swaps the
+// packet's completion signal for one from the pool; when it fires, the
+// application's signal is forwarded and a background thread reads the
+// profiler timestamps and recycles the signal.
+class dispatch_timer {
+ public:
+  struct counters {
+    std::uint64_t attached;
+    std::uint64_t completed;
+    std::uint64_t exhausted;  // no free signal, dispatch not timed
+    std::uint64_t failed;     // handler or timestamps unavailable
+  };
+
+  dispatch_timer(const dispatch_timer_api& api, std::size_t max_signals);
+  ~dispatch_timer();
+
+  // Returns the signal to put in the packet, or nullopt to leave it untouched
+  std::optional<std::uint64_t> attach(std::uint64_t kernel_object,
+                                      std::uint64_t agent,
+                                      std::uint64_t app_signal);
+
+  // Waits up to timeout for in-flight dispatches, then stops the harvester
+  void stop(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+  std::unordered_map<std::uint64_t, kernel_timing> get_timings() const;
+  counters get_counters() const;
+
+ private:
+  struct slot {
+    dispatch_timer* timer;
+    std::uint32_t index;
+    std::uint64_t signal{0};
+    std::uint64_t app_signal{0};
+    std::uint64_t kernel_object{0};
+    std::uint64_t agent{0};
+  };
+
+  static bool on_complete(std::int64_t value, void* arg);
+  void run();
+  void harvest(slot& s);
+
+  dispatch_timer_api api_;
+  std::unique_ptr<slot[]> slots_;
+  std::size_t num_slots_;
+  mpmc_ring<std::uint32_t> free_;
+  mpmc_ring<std::uint32_t> completed_;
+
+  mutable std::mutex timings_mutex_;
+  std::unordered_map<std::uint64_t, kernel_timing> timings_;
+
+  std::atomic<std::uint64_t> attached_{0};
+  std::atomic<std::uint64_t> completed_count_{0};
+  std::atomic<std::uint64_t> exhausted_{0};
+  std::atomic<std::uint64_t> failed_{0};
+  std::atomic<bool> stop_{false};
+  std::thread harvester_;
+};
+
+}  // namespace maestro
@@ -0,0 +1,418 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "extraction_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#include "log.hpp"
+
+namespace maestro {
+
+namespace {
+
+constexpr char entry_magic[8] = {'N', 'X', 'C', 'A', 'C', 'H', 'E', '1'};
+constexpr std::uint64_t entry_version = 1;
+constexpr std::size_t header_size = sizeof(entry_magic) + 3 * 8;
+constexpr std::size_t checksum_size = 8;
+constexpr const char* entry_extension = ".nxc";
+
+void put_u64(std::string& out, std::uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+std::uint64_t get_u64(const unsigned char* p) {
+  std::uint64_t value = 0;
+  for (int i = 7; i >= 0; i--) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+void put_string(std::string& out, std::string_view s) {
+  put_varint(out, s.size());
+  out += s;
+}
+
+bool get_string(const unsigned char*& p, const unsigned char* end, std::string_view& s) {
+  std::uint64_t size;
+  if (!get_varint(p, end, size) || size > static_cast<std::uint64_t>(end - p)) {
+    return false;
+  }
+  s = std::string_view(reinterpret_cast<const char*>(p), size);
+  p += size;
+  return true;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+struct file_state {
+  std::int64_t mtime_ns;
+  std::uint64_t size;
+};
+
+std::optional<file_state> stat_file(const std::string& path) {
+  struct stat st {};
+  if (::stat(path.c_str(), &st) != 0) {
+    return std::nullopt;
+  }
+  return file_state{st.st_mtim.tv_sec * 1'000'000'000ll + st.st_mtim.tv_nsec,
+                    static_cast<std::uint64_t>(st.st_size)};
+}
+
+// Parses the record after the header; assembly views the entry's bytes
+bool parse_record(const unsigned char*& p,
+                  const unsigned char* end,
+                  kernel_record& record) {
+  std::string_view s;
+  std::uint64_t count;
+  if (!get_string(p, end, s)) {
+    return false;
+  }
+  record.name = s;
+  if (!get_string(p, end, s) || !get_varint(p, end, count) ||
+      count > static_cast<std::uint64_t>(end - p)) {
+    return false;
+  }
+  record.signature = s;
+  record.lines.resize(count);
+  std::int64_t line = 0;
+  for (auto& value : record.lines) {
+    std::uint64_t delta;
+    if (!get_varint(p, end, delta)) {
+      return false;
+    }
+    line += unzigzag(delta);
+    value = static_cast<std::uint32_t>(line);
+  }
+  const auto get_strings = [&](auto& strings) {
+    if (!get_varint(p, end, count) || count > static_cast<std::uint64_t>(end - p)) {
+      return false;
+    }
+    strings.resize(count);
+    for (auto& out : strings) {
+      if (!get_string(p, end, s)) {
+        return false;
+      }
+      out = s;
+    }
+    return true;
+  };
+  if (!get_strings(record.files) || !get_strings(record.hip) ||
+      !get_strings(record.assembly)) {
+    return false;
+  }
+  if (!get_varint(p, end, count) || count > static_cast<std::uint64_t>(end - p)) {
+    return false;
+  }
+  record.source_index.resize(count);
+  for (auto& index : record.source_index) {
+    std::uint64_t value;
+    if (!get_varint(p, end, value)) {
+      return false;
+    }
+    index = static_cast<std::int32_t>(value) - 1;
+  }
+  return p == end;
+}
+
+}  // namespace
+
+cached_kernel::cached_kernel(cached_kernel&& other) noexcept
+    : record(std::move(other.record)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+cached_kernel::~cached_kernel() {
+  if (data_) {
+    munmap(const_cast<void*>(data_), size_);
+  }
+}
+
+extraction_cache::extraction_cache(std::filesystem::path dir, std::uint64_t max_bytes)
+    : dir_(std::move(dir)), max_bytes_(max_bytes) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    LOG_WARN("Cannot create the extraction cache {}: {}", dir_.string(), ec.message());
+  }
+}
+
+code_object_hash extraction_cache::key(std::vector<code_object_hash> code_objects,
+                                       const std::string& kernel,
+                                       const std::string& salt) {
+  // Load order does not change what the kernel's code objects contain
+  std::sort(code_objects.begin(), code_objects.end(), [](const auto& a, const auto& b) {
+    return std::tie(a.high, a.low) < std::tie(b.high, b.low);
+  });
+  std::string material;
+  put_u64(material, entry_version);
+  for (const auto& hash : code_objects) {
+    put_u64(material, hash.high);
+    put_u64(material, hash.low);
+  }
+  put_string(material, kernel);
+  put_string(material, salt);
+  return hash_code_object(material.data(), material.size());
+}
+
+std::filesystem::path extraction_cache::entry_path(const code_object_hash& key) const {
+  return dir_ / (key.to_string() + entry_extension);
+}
+
+std::optional<cached_kernel> extraction_cache::load(const code_object_hash& key) {
+  const auto path = entry_path(key);
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<std::size_t>(st.st_size) < header_size + checksum_size) {
+    ::close(fd);
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  cached_kernel entry(data, st.st_size);
+  const auto* begin = static_cast<const unsigned char*>(data);
+  const auto* end = begin + st.st_size - checksum_size;
+  const auto* p = begin + header_size;
+  const bool valid =
+      std::memcmp(begin, entry_magic, sizeof(entry_magic)) == 0 &&
+      get_u64(begin + 8) == entry_version && get_u64(begin + 16) == key.high &&
+      get_u64(begin + 24) == key.low &&
+      get_u64(end) == XXH3_64bits(begin, st.st_size - checksum_size);
+
+  std::uint64_t num_sources = 0;
+  if (!valid || !get_varint(p, end, num_sources)) {
+    LOG_WARN("Ignoring the corrupt cache entry {}", path.string());
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  for (std::uint64_t i = 0; i < num_sources; i++) {
+    std::string_view source;
+    std::uint64_t mtime, size;
+    if (!get_string(p, end, source) || !get_varint(p, end, mtime) ||
+        !get_varint(p, end, size)) {
+      errors_.fetch_add(1, std::memory_order_relaxed);
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    const auto state = stat_file(std::string(source));
+    if (!state || state->mtime_ns != unzigzag(mtime) || state->size != size) {
+      LOG_DETAIL("Cache entry {} is stale: {} changed", path.string(), source);
+      stale_.fetch_add(1, std::memory_order_relaxed);
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+  }
+
+  if (!parse_record(p, end, entry.record)) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  // The mtime orders entries for eviction
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return entry;
+}
+
+bool extraction_cache::store(const code_object_hash& key,
+                             const kernel_record& record,
+                             const std::vector<std::string>& sources) {
+  std::string out(entry_magic, sizeof(entry_magic));
+  put_u64(out, entry_version);
+  put_u64(out, key.high);
+  put_u64(out, key.low);
+
+  put_varint(out, sources.size());
+  for (const auto& source : sources) {
+    const auto state = stat_file(source);
+    if (!state) {
+      // Gone already; nothing to validate a later hit against
+      return false;
+    }
+    put_string(out, source);
+    put_varint(out, zigzag(state->mtime_ns));
+    put_varint(out, state->size);
+  }
+
+  put_string(out, record.name);
+  put_string(out, record.signature);
+  put_varint(out, record.lines.size());
+  std::int64_t previous = 0;
+  for (const auto line : record.lines) {
+    put_varint(out, zigzag(static_cast<std::int64_t>(line) - previous));
+    previous = line;
+  }
+  const auto put_strings = [&](const auto& strings) {
+    put_varint(out, strings.size());
+    for (const auto& s : strings) {
+      put_string(out, s);
+    }
+  };
+  put_strings(record.files);
+  put_strings(record.hip);
+  put_strings(record.assembly);
+  put_varint(out, record.source_index.size());
+  for (const auto index : record.source_index) {
+    put_varint(out, static_cast<std::uint64_t>(index + 1));
+  }
+  put_u64(out, XXH3_64bits(out.data(), out.size()));
+
+  // Unique per process and call, so concurrent writers never share a file
+  static std::atomic<std::uint64_t> sequence{0};
+  const auto path = entry_path(key);
+  const auto tmp_path = fmt::format("{}.{}.{}.tmp",
+                                    path.string(),
+                                    ::getpid(),
+                                    sequence.fetch_add(1, std::memory_order_relaxed));
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::trunc | std::ios::binary);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+      file.close();
+      std::remove(tmp_path.c_str());
+      errors_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  stores_.fetch_add(1, std::memory_order_relaxed);
+
+  std::lock_guard lock(mutex_);
+  if (!dir_bytes_) {
+    evict();
+  } else {
+    *dir_bytes_ += out.size();
+    if (*dir_bytes_ > max_bytes_) {
+      evict();
+    }
+  }
+  return true;
+}
+
+void extraction_cache::evict() {
+  // Other processes add and remove entries too, so start from the directory
+  struct entry {
+    std::filesystem::file_time_type time;
+    std::uint64_t size;
+    std::filesystem::path path;
+  };
+  std::vector<entry> entries;
+  std::uint64_t total = 0;
+  std::error_code ec;
+  const auto now = std::filesystem::file_time_type::clock::now();
+  for (const auto& file : std::filesystem::directory_iterator(dir_, ec)) {
+    std::error_code file_ec;
+    const auto time = file.last_write_time(file_ec);
+    const auto size = file.file_size(file_ec);
+    if (file_ec) {
+      continue;
+    }
+    const auto& path = file.path();
+    if (path.extension() == ".tmp") {
+      // Left behind by a process that died while writing
+      if (now - time > std::chrono::hours(1)) {
+        std::filesystem::remove(path, file_ec);
+      }
+      continue;
+    }
+    if (path.extension() != entry_extension) {
+      continue;
+    }
+    entries.push_back({time, size, path});
+    total += size;
+  }
+
+  if (total > max_bytes_) {
+    // Down to 90% so that the next few stores do not rescan
+    const auto target = max_bytes_ / 10 * 9;
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+      return a.time < b.time;
+    });
+    for (const auto& e : entries) {
+      if (total <= target) {
+        break;
+      }
+      std::error_code file_ec;
+      if (std::filesystem::remove(e.path, file_ec)) {
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+      }
+      total -= e.size;
+    }
+  }
+  dir_bytes_ = total;
+}
+
+extraction_cache::counters extraction_cache::get_counters() const {
+  return {hits_.load(std::memory_order_relaxed),
+          misses_.load(std::memory_order_relaxed),
+          stale_.load(std::memory_order_relaxed),
+          stores_.load(std::memory_order_relaxed),
+          evictions_.load(std::memory_order_relaxed),
+          errors_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace maestro
@@ -0,0 +1,115 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "code_object.hpp"
+#include "trace_format.hpp"
+
+namespace maestro {
+
+// A cache entry mapped into memory. record.assembly views the mapping, so the
+// entry must outlive any use of it.
+class cached_kernel {
+ public:
+  cached_kernel(cached_kernel&& other) noexcept;
+  cached_kernel& operator=(cached_kernel&&) = delete;
+  ~cached_kernel();
+
+  kernel_record record;
+
+ private:
+  friend class extraction_cache;
+  cached_kernel(const void* data, std::size_t size) : data_(data), size_(size) {}
+
+  const void* data_;
+  std::size_t size_;
+};
+
+// Extracted kernel records kept on disk across runs, one file per kernel
+// named after a key derived from the kernel's code objects. Each entry lists
+// the source files its text was read from, with their mtime and size, and is
+// only used while they are unchanged.
+//
+// Entries are written to a temporary file and renamed into place, so any
+// number of processes can share a directory: readers see a whole entry or
+// none. Hits refresh the entry's mtime, and when a store takes the directory
+// over max_bytes the least recently used entries are removed.
+class extraction_cache {
+ public:
+  struct counters {
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t stale;  // misses because a source file changed
+    std::uint64_t stores;
+    std::uint64_t evictions;
+    std::uint64_t errors;
+  };
+
+  extraction_cache(std::filesystem::path dir, std::uint64_t max_bytes);
+
+  // Key of kernel within the code objects it was loaded from. salt covers
+  // anything else the record depends on, such as the search paths.
+  static code_object_hash key(std::vector<code_object_hash> code_objects,
+                              const std::string& kernel,
+                              const std::string& salt);
+
+  std::optional<cached_kernel> load(const code_object_hash& key);
+
+  // sources are the resolved paths of the files record.hip was read from
+  bool store(const code_object_hash& key,
+             const kernel_record& record,
+             const std::vector<std::string>& sources);
+
+  counters get_counters() const;
+  const std::filesystem::path& directory() const { return dir_; }
+
+ private:
+  std::filesystem::path entry_path(const code_object_hash& key) const;
+  void evict();
+
+  std::filesystem::path dir_;
+  std::uint64_t max_bytes_;
+
+  std::mutex mutex_;  // directory size and eviction
+  std::optional<std::uint64_t> dir_bytes_;
+
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+  std::atomic<std::uint64_t> stale_{0};
+  std::atomic<std::uint64_t> stores_{0};
+  std::atomic<std::uint64_t> evictions_{0};
+  std::atomic<std::uint64_t> errors_{0};
+};
+
+}  // namespace maestro
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "isa_store.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace maestro {
+
+namespace {
+// Instructions are tens of bytes; a chunk holds tens of thousands of them
+constexpr std::size_t chunk_size = 1 << 20;
+
+bool same_instructions(const std::vector<std::string_view>& a,
+                       const std::vector<std::string_view>& b) {
+  // Interned views are equal exactly when they point at the same bytes
+  return std::equal(a.begin(),
+                    a.end(),
+                    b.begin(),
+                    b.end(),
+                    [](std::string_view x, std::string_view y) {
+                      return x.data() == y.data() && x.size() == y.size();
+                    });
+}
+}  // namespace
+
+std::size_t strip_tabs(std::string_view in, char* out) {
+  const char* src = in.data();
+  const std::size_t n = in.size();
+  std::size_t i = 0;
+  std::size_t o = 0;
+#if defined(__SSE2__)
+  // 16 bytes at a time; most chunks hold no tab and are copied as a whole
+  const __m128i tab = _mm_set1_epi8('\t');
+  for (; i + 16 <= n; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, tab));
+    if (!mask) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), chunk);
+      o += 16;
+      continue;
+    }
+    for (unsigned j = 0; j < 16; j++) {
+      out[o] = src[i + j];
+      o += !((mask >> j) & 1);
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    out[o] = src[i];
+    o += src[i] != '\t';
+  }
+  return o;
+}
+
+std::string_view isa_store::store_locked(std::string_view s) {
+  // Kept at most half full; hash 0 marks an empty slot
+  if (2 * (num_strings_ + 1) > slots_.size()) {
+    std::vector<slot> slots(std::max<std::size_t>(slots_.size() * 2, 1024), slot{});
+    const auto mask = slots.size() - 1;
+    for (const auto& old : slots_) {
+      if (old.hash) {
+        auto i = old.hash & mask;
+        while (slots[i].hash) {
+          i = (i + 1) & mask;
+        }
+        slots[i] = old;
+      }
+    }
+    slots_ = std::move(slots);
+  }
+
+  const auto hash = std::max<std::uint64_t>(XXH3_64bits(s.data(), s.size()), 1);
+  const auto mask = slots_.size() - 1;
+  auto i = hash & mask;
+  for (; slots_[i].hash; i = (i + 1) & mask) {
+    const auto& candidate = slots_[i];
+    if (candidate.hash == hash && std::string_view(candidate.data, candidate.size) == s) {
+      return {candidate.data, candidate.size};
+    }
+  }
+
+  if (s.size() > remaining_) {
+    const auto size = std::max(chunk_size, s.size());
+    chunks_.push_back(std::make_unique<char[]>(size));
+    cursor_ = chunks_.back().get();
+    remaining_ = size;
+  }
+  std::copy(s.begin(), s.end(), cursor_);
+  const std::string_view stored(cursor_, s.size());
+  cursor_ += s.size();
+  remaining_ -= s.size();
+  arena_bytes_ += s.size();
+  slots_[i] = {hash, stored.data(), stored.size()};
+  num_strings_++;
+  return stored;
+}
+
+const isa_block& isa_store::intern(std::string_view kernel,
+                                   std::span<const std::string_view> raw) {
+  // Strip into a per-thread buffer so the lock only covers the lookups
+  thread_local std::string buffer;
+  thread_local std::vector<std::size_t> ends;
+  std::size_t total = 0;
+  for (const auto instruction : raw) {
+    total += instruction.size();
+  }
+  buffer.resize(total);
+  ends.clear();
+  std::size_t offset = 0;
+  for (const auto instruction : raw) {
+    offset += strip_tabs(instruction, buffer.data() + offset);
+    ends.push_back(offset);
+  }
+
+  std::vector<std::string_view> instructions;
+  instructions.reserve(raw.size());
+  std::lock_guard lock(mutex_);
+  std::size_t begin = 0;
+  for (const auto end : ends) {
+    instructions.push_back(
+        store_locked(std::string_view(buffer.data() + begin, end - begin)));
+    begin = end;
+  }
+  return intern_locked(kernel, instructions);
+}
+
+const isa_block& isa_store::intern_locked(std::string_view kernel,
+                                          std::vector<std::string_view>& instructions) {
+  instructions_ += instructions.size();
+  kernels_++;
+
+  // Hash the addresses of the interned instructions rather than their text
+  std::vector<const char*> addresses(instructions.size());
+  for (std::size_t i = 0; i < instructions.size(); i++) {
+    addresses[i] = instructions[i].data();
+  }
+  const auto hash = XXH3_64bits(addresses.data(), addresses.size() * sizeof(const char*));
+
+  auto [first, last] = blocks_.equal_range(hash);
+  for (auto it = first; it != last; ++it) {
+    auto& block = *it->second;
+    if (same_instructions(block.instructions, instructions)) {
+      if (kernel < block.owner) {
+        block.owner = store_locked(kernel);
+      }
+      return block;
+    }
+  }
+
+  auto block = std::make_unique<isa_block>();
+  block->instructions = std::move(instructions);
+  block->owner = store_locked(kernel);
+  block->hash = hash;
+  return *blocks_.emplace(hash, std::move(block))->second;
+}
+
+isa_store::stats isa_store::get_stats() const {
+  std::lock_guard lock(mutex_);
+  return {arena_bytes_, instructions_, num_strings_, kernels_, blocks_.size()};
+}
+
+}  // namespace maestro
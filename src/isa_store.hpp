@@ -0,0 +1,104 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace maestro {
+
+// Copies in to out without tab characters and returns the number of bytes
+// written; out must have room for in.size() bytes.
+std::size_t strip_tabs(std::string_view in, char* out);
+
+// The disassembly of one kernel. Kernels that disassemble to the same text
+// (template instantiations, clones) share a single block.
+struct isa_block {
+  std::vector<std::string_view> instructions;
+  // Smallest name among the kernels interned with this body. Kernels are
+  // written in full while they own their block, so later kernels can refer
+  // to the owner instead of repeating the text. Changes on intern; read it
+  // under the same serialization as the interning.
+  std::string_view owner;
+  std::uint64_t hash{0};
+};
+
+// Append-only storage for ISA text. Instructions are stored once, tab
+// stripped, in large arena chunks and handed out as string_views that stay
+// valid for the lifetime of the store; identical instructions and identical
+// kernel bodies are deduplicated by content hash. Thread safe.
+class isa_store {
+ public:
+  struct stats {
+    std::size_t arena_bytes;
+    std::size_t instructions;
+    std::size_t unique_strings;
+    std::size_t kernels;
+    std::size_t unique_blocks;
+  };
+
+  isa_store() = default;
+  isa_store(const isa_store&) = delete;
+  isa_store& operator=(const isa_store&) = delete;
+
+  // Interns the raw disassembly of kernel and returns its (possibly shared)
+  // body. Tabs are stripped before the lock is taken.
+  const isa_block& intern(std::string_view kernel,
+                          std::span<const std::string_view> raw);
+
+  stats get_stats() const;
+
+ private:
+  // Open addressing over the arena: one hash per lookup and no node per string
+  struct slot {
+    std::uint64_t hash;
+    const char* data;
+    std::size_t size;
+  };
+
+  std::string_view store_locked(std::string_view s);
+  const isa_block& intern_locked(std::string_view kernel,
+                                 std::vector<std::string_view>& instructions);
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char* cursor_{nullptr};
+  std::size_t remaining_{0};
+  std::size_t arena_bytes_{0};
+  std::vector<slot> slots_;
+  std::size_t num_strings_{0};
+  std::unordered_multimap<std::uint64_t, std::unique_ptr<isa_block>> blocks_;
+  std::size_t instructions_{0};
+  std::size_t kernels_{0};
+};
+
+}  // namespace maestro
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "kernarg_scan.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace maestro {
+
+kernarg_scanner::kernarg_scanner(const allocation_registry& registry,
+                                 std::size_t capacity)
+    : registry_(registry), ring_(capacity), batch_(batch_records) {
+  scanner_ = std::thread([this]() { run(); });
+}
+
+kernarg_scanner::~kernarg_scanner() {
+  stop();
+}
+
+void kernarg_scanner::submit(std::uint64_t kernel_object,
+                             const void* kernarg,
+                             std::size_t size) {
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+  // Pointers are 8-byte aligned in the kernarg segment
+  auto num_words = size / sizeof(std::uint64_t);
+  if (num_words > max_words) {
+    truncated_.fetch_add(1, std::memory_order_relaxed);
+    num_words = max_words;
+  }
+
+  record r;
+  r.kernel_object = kernel_object;
+  r.num_words = static_cast<std::uint32_t>(num_words);
+  std::memcpy(r.words, kernarg, num_words * sizeof(std::uint64_t));
+  if (!ring_.try_push(r)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void kernarg_scanner::run() {
+  auto backoff = std::chrono::microseconds(1);
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (scan_batch()) {
+      backoff = std::chrono::microseconds(1);
+      continue;
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+  }
+}
+
+bool kernarg_scanner::scan_batch() {
+  auto& records = batch_;
+  std::size_t num_records = 0;
+  while (num_records < batch_records && ring_.try_pop(records[num_records])) {
+    num_records++;
+  }
+  if (num_records == 0) {
+    return false;
+  }
+
+  // Resolve every distinct word of the batch in one registry pass
+  std::vector<std::uint64_t> words;
+  for (std::size_t i = 0; i < num_records; i++) {
+    const auto& r = records[i];
+    std::copy_if(r.words,
+                 r.words + r.num_words,
+                 std::back_inserter(words),
+                 [](std::uint64_t word) { return word != 0; });
+  }
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  std::vector<std::optional<allocation>> resolved(words.size());
+  registry_.find_many(words.data(), words.size(), resolved.data());
+
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> buffers;
+  std::lock_guard g(footprints_mutex_);
+  for (std::size_t i = 0; i < num_records; i++) {
+    const auto& r = records[i];
+    buffers.clear();
+    for (std::uint32_t w = 0; w < r.num_words; w++) {
+      const auto it = std::lower_bound(words.begin(), words.end(), r.words[w]);
+      if (it != words.end() && *it == r.words[w]) {
+        if (const auto& a = resolved[it - words.begin()]) {
+          buffers.emplace_back(a->base, a->size);
+        }
+      }
+    }
+    // Several arguments may point into the same buffer
+    std::sort(buffers.begin(), buffers.end());
+    buffers.erase(std::unique(buffers.begin(), buffers.end()), buffers.end());
+
+    auto& footprint = footprints_[r.kernel_object];
+    std::uint64_t bytes = 0;
+    for (const auto& [base, size] : buffers) {
+      bytes += size;
+      footprint.buffers[base] = size;
+    }
+    footprint.dispatches++;
+    footprint.total_bytes += bytes;
+    footprint.max_bytes = std::max(footprint.max_bytes, bytes);
+  }
+  scanned_.fetch_add(num_records, std::memory_order_relaxed);
+  return true;
+}
+
+void kernarg_scanner::stop() {
+  if (!scanner_.joinable()) {
+    return;
+  }
+  stop_.store(true, std::memory_order_release);
+  scanner_.join();
+  while (scan_batch()) {
+  }
+}
+
+std::unordered_map<std::uint64_t, kernel_footprint> kernarg_scanner::get_footprints()
+    const {
+  std::lock_guard g(footprints_mutex_);
+  return footprints_;
+}
+
+kernarg_scanner::counters kernarg_scanner::get_counters() const {
+  return {submitted_.load(std::memory_order_relaxed),
+          scanned_.load(std::memory_order_relaxed),
+          dropped_.load(std::memory_order_relaxed),
+          truncated_.load(std::memory_order_relaxed),
+          device_resident_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace maestro
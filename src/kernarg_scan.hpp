@@ -0,0 +1,115 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "allocation_registry.hpp"
+#include "dispatch_pipeline.hpp"
+
+namespace maestro {
+
+// Buffers a kernel was handed through its kernel arguments, across all of
+// its scanned dispatches.
+struct kernel_footprint {
+  std::uint64_t dispatches{0};
+  std::uint64_t total_bytes{0};  // sum of per-dispatch footprints
+  std::uint64_t max_bytes{0};    // largest single-dispatch footprint
+  std::map<std::uint64_t, std::uint64_t> buffers;  // base -> size
+};
+
+// Finds which known allocations each dispatch can reach through its kernarg
+// segment. submit() only copies the kernarg words into a ring; a background
+// thread resolves them against the allocation registry a batch at a time.
+class kernarg_scanner {
+ public:
+  // Words copied per dispatch; longer segments are truncated
+  static constexpr std::size_t max_words = 64;
+
+  struct counters {
+    std::uint64_t submitted;
+    std::uint64_t scanned;
+    std::uint64_t dropped;          // ring full
+    std::uint64_t truncated;        // kernarg segment longer than max_words
+    std::uint64_t device_resident;  // kernarg segment in device memory, not read
+  };
+
+  kernarg_scanner(const allocation_registry& registry, std::size_t capacity);
+  ~kernarg_scanner();
+
+  kernarg_scanner(const kernarg_scanner&) = delete;
+  kernarg_scanner& operator=(const kernarg_scanner&) = delete;
+
+  // Never blocks or allocates
+  void submit(std::uint64_t kernel_object, const void* kernarg, std::size_t size);
+
+  // Counts a dispatch whose kernarg segment lives in device memory. It is not
+  // read: every word would be an uncached read across the bus.
+  void skip_device_resident() {
+    device_resident_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Scans what is still queued and stops the background thread
+  void stop();
+
+  std::unordered_map<std::uint64_t, kernel_footprint> get_footprints() const;
+  counters get_counters() const;
+
+ private:
+  struct record {
+    std::uint64_t kernel_object;
+    std::uint32_t num_words;
+    std::uint64_t words[max_words];
+  };
+
+  static constexpr std::size_t batch_records = 256;
+
+  void run();
+  // Returns false when nothing was queued
+  bool scan_batch();
+
+  const allocation_registry& registry_;
+  mpmc_ring<record> ring_;
+  std::vector<record> batch_;
+
+  mutable std::mutex footprints_mutex_;
+  std::unordered_map<std::uint64_t, kernel_footprint> footprints_;
+
+  std::atomic<std::uint64_t> submitted_{0};
+  std::atomic<std::uint64_t> scanned_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> truncated_{0};
+  std::atomic<std::uint64_t> device_resident_{0};
+  std::atomic<bool> stop_{false};
+  std::thread scanner_;
+};
+
+}  // namespace maestro
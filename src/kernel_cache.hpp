@@ -0,0 +1,115 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "concurrent_map.hpp"
+
+namespace maestro {
+
+// Per-kernel_object state recorded the first time a kernel is dispatched.
+struct kernel_entry {
+  std::string name;
+  bool traced{false};
+  std::atomic<std::uint64_t> dispatches{0};
+
+  kernel_entry(std::string n, bool t) : name(std::move(n)), traced(t) {}
+};
+
+// Maps kernel_object handles to the kernel they were resolved to, so that
+// repeated dispatches of an already processed kernel skip name resolution,
+// filtering and extraction. Hits are wait-free; only inserts and evictions
+// take the mutex.
+class kernel_cache {
+ public:
+  // Returns the entry and bumps its dispatch counter, or nullptr on a miss.
+  kernel_entry* hit(std::uint64_t kernel_object) {
+    auto* entry = index_.find(kernel_object);
+    if (entry) {
+      entry->dispatches.fetch_add(1, std::memory_order_relaxed);
+    }
+    return entry;
+  }
+
+  // Inserts an entry for a kernel_object seen for the first time. If another
+  // thread raced us, the existing entry is kept.
+  kernel_entry& insert(std::uint64_t kernel_object, std::string name, bool traced) {
+    std::lock_guard lock(mutex_);
+    auto [it, inserted] = entries_.try_emplace(kernel_object, nullptr);
+    if (inserted) {
+      it->second = std::make_unique<kernel_entry>(std::move(name), traced);
+      index_.insert(kernel_object, it->second.get());
+    }
+    it->second->dispatches.fetch_add(1, std::memory_order_relaxed);
+    return *it->second;
+  }
+
+  // Forgets a kernel_object whose executable is being destroyed, so that a
+  // handle reused by later code misses. The entry is kept for dispatches that
+  // still hold it and for the stats.
+  void evict(std::uint64_t kernel_object) {
+    std::lock_guard lock(mutex_);
+    auto it = entries_.find(kernel_object);
+    if (it == entries_.end()) {
+      return;
+    }
+    index_.erase(kernel_object);
+    evicted_.emplace_back(kernel_object, std::move(it->second));
+    entries_.erase(it);
+  }
+
+  std::size_t size() const {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+  }
+
+  // Live entries first, then evicted ones
+  template <typename F>
+  void for_each(F&& f) const {
+    std::lock_guard lock(mutex_);
+    for (const auto& [kernel_object, entry] : entries_) {
+      f(kernel_object, *entry);
+    }
+    for (const auto& [kernel_object, entry] : evicted_) {
+      f(kernel_object, *entry);
+    }
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::uint64_t, std::unique_ptr<kernel_entry>> entries_;
+  std::vector<std::pair<std::uint64_t, std::unique_ptr<kernel_entry>>> evicted_;
+  concurrent_map<kernel_entry> index_;
+};
+
+}  // namespace maestro
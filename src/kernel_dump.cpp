@@ -0,0 +1,155 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "kernel_dump.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "log.hpp"
+#include "trace_writer.hpp"
+
+namespace maestro {
+
+namespace {
+// Small enough to balance uneven kernels, large enough to amortize a task
+constexpr std::size_t kernels_per_chunk = 64;
+}  // namespace
+
+std::string render_kernel_dump(std::vector<std::string> kernels,
+                               const kernel_isa_fn& isa,
+                               isa_store& store,
+                               std::size_t num_threads,
+                               bool shared_isa) {
+  // Same order and de-duplication as a JSON object keyed by name
+  std::sort(kernels.begin(), kernels.end());
+  kernels.erase(std::unique(kernels.begin(), kernels.end()), kernels.end());
+  std::erase(kernels, ".text");
+
+  const auto num_chunks = (kernels.size() + kernels_per_chunk - 1) / kernels_per_chunk;
+  std::vector<std::string> chunks(num_chunks);
+  std::vector<std::size_t> chunk_kernels(num_chunks, 0);
+  std::vector<const isa_block*> blocks(kernels.size(), nullptr);
+
+  num_threads =
+      std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(num_chunks, 1));
+  const auto run = [num_threads](const auto& worker) {
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < num_threads; t++) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers) {
+      w.join();
+    }
+  };
+
+  // Intern every kernel first so that block owners are final before any
+  // record decides between a copy and a reference
+  std::atomic<std::size_t> next_chunk{0};
+  run([&]() {
+    std::vector<std::string_view> raw;
+    for (auto chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+         chunk = next_chunk.fetch_add(1)) {
+      const auto first = chunk * kernels_per_chunk;
+      const auto last = std::min(first + kernels_per_chunk, kernels.size());
+      for (auto i = first; i < last; i++) {
+        raw.clear();
+        if (isa(kernels[i], raw)) {
+          blocks[i] = &store.intern(kernels[i], raw);
+        }
+      }
+    }
+  });
+
+  next_chunk = 0;
+  run([&]() {
+    for (auto chunk = next_chunk.fetch_add(1); chunk < num_chunks;
+         chunk = next_chunk.fetch_add(1)) {
+      const auto first = chunk * kernels_per_chunk;
+      const auto last = std::min(first + kernels_per_chunk, kernels.size());
+      auto& out = chunks[chunk];
+      for (auto i = first; i < last; i++) {
+        const auto* block = blocks[i];
+        if (!block) {
+          continue;
+        }
+        nlohmann::json record;
+        if (shared_isa && !block->instructions.empty() && block->owner != kernels[i]) {
+          record["assembly_ref"] = block->owner;
+        } else {
+          record["assembly"] = block->instructions;
+        }
+        record["signature"] = kernels[i];
+        // Every entry gets the separator of a non-first entry; the join drops
+        // the comma in front of the first one
+        out += trace_writer::entry_separator(1);
+        out += trace_writer::format_entry(kernels[i], record);
+        chunk_kernels[chunk]++;
+      }
+    }
+  });
+
+  std::size_t size = trace_writer::document_begin.size() + 16;
+  std::size_t written = 0;
+  for (std::size_t chunk = 0; chunk < num_chunks; chunk++) {
+    size += chunks[chunk].size();
+    written += chunk_kernels[chunk];
+  }
+  std::string document;
+  document.reserve(size);
+  document += trace_writer::document_begin;
+  for (auto& chunk : chunks) {
+    document += chunk;
+    chunk = {};
+  }
+  if (written) {
+    document.erase(trace_writer::document_begin.size(), 1);
+  }
+  document += trace_writer::document_end(written);
+  LOG_DETAIL("Rendered {} kernels in {} chunks", written, num_chunks);
+  return document;
+}
+
+bool write_file_atomically(const std::string& path, const std::string& contents) {
+  const auto tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if (!out) {
+      return false;
+    }
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+}  // namespace maestro
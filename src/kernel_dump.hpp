@@ -0,0 +1,58 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "isa_store.hpp"
+
+namespace maestro {
+
+// Fills the raw disassembly of one kernel as views that stay valid until the
+// dump returns; may be called from several threads at once. Returns false if
+// the kernel cannot be read.
+using kernel_isa_fn =
+    std::function<bool(const std::string& kernel, std::vector<std::string_view>& isa)>;
+
+// Renders the NEXUS_KERNELS_DUMP_FILE document for kernels, in name order.
+// Kernels are split into contiguous chunks that num_threads workers first
+// intern into store and then serialize independently; the chunks are
+// concatenated in order, so the output does not depend on the thread count.
+// With shared_isa, a kernel whose assembly matches a kernel earlier in name
+// order gets an "assembly_ref" to it instead of a copy.
+std::string render_kernel_dump(std::vector<std::string> kernels,
+                               const kernel_isa_fn& isa,
+                               isa_store& store,
+                               std::size_t num_threads,
+                               bool shared_isa = false);
+
+// Writes contents to path through a temporary file and a rename
+bool write_file_atomically(const std::string& path, const std::string& contents);
+
+}  // namespace maestro
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "kernel_filter.hpp"
+
+#include <fmt/core.h>
+#include <algorithm>
+
+#include "log.hpp"
+
+namespace maestro {
+
+// '*' matches any run of characters, '?' any single one
+static bool glob_match(std::string_view pattern, std::string_view name) {
+  std::size_t p = 0;
+  std::size_t n = 0;
+  std::size_t star = std::string_view::npos;
+  std::size_t resume = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      p++;
+      n++;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      resume = n;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      n = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    p++;
+  }
+  return p == pattern.size();
+}
+
+kernel_filter::rule kernel_filter::compile(std::string_view token) {
+  if (token.starts_with("re:")) {
+    const std::string expr(token.substr(3));
+    return {kind::REGEX, expr, std::regex(expr, std::regex::optimize)};
+  }
+
+  const auto wildcard = token.find_first_of("*?");
+  if (wildcard == std::string_view::npos) {
+    return {kind::SUBSTRING, std::string(token), {}};
+  }
+  // "name*" is by far the most common glob
+  if (wildcard == token.size() - 1 && token.back() == '*') {
+    return {kind::PREFIX, std::string(token.substr(0, wildcard)), {}};
+  }
+  return {kind::GLOB, std::string(token), {}};
+}
+
+bool kernel_filter::rule::matches(std::string_view name) const {
+  switch (type) {
+    case kind::SUBSTRING:
+      return name.find(pattern) != std::string_view::npos;
+    case kind::PREFIX:
+      return name.starts_with(pattern);
+    case kind::GLOB:
+      return glob_match(pattern, name);
+    case kind::REGEX:
+      return std::regex_search(name.begin(), name.end(), regex);
+  }
+  return false;
+}
+
+kernel_filter::kernel_filter(const char* spec) {
+  if (spec == nullptr) {
+    return;
+  }
+  std::string_view tokens(spec);
+  while (!tokens.empty()) {
+    const auto end = std::min(tokens.find(';'), tokens.size());
+    auto token = tokens.substr(0, end);
+    tokens.remove_prefix(std::min(end + 1, tokens.size()));
+    if (token.empty()) {
+      continue;
+    }
+
+    const bool exclude = token.front() == '!';
+    if (exclude) {
+      token.remove_prefix(1);
+    }
+    try {
+      (exclude ? excludes_ : includes_).push_back(compile(token));
+    } catch (const std::regex_error& e) {
+      LOG_ERROR("Ignoring invalid kernel filter {}: {}", token, e.what());
+    }
+  }
+  none_ = includes_.empty() && excludes_.empty();
+}
+
+bool kernel_filter::matches(std::string_view name) const {
+  if (none_) {
+    return false;
+  }
+  const auto match = [name](const rule& r) { return r.matches(name); };
+  if (!includes_.empty() && std::none_of(includes_.begin(), includes_.end(), match)) {
+    return false;
+  }
+  return std::none_of(excludes_.begin(), excludes_.end(), match);
+}
+
+std::string kernel_filter::describe() const {
+  if (none_) {
+    return "no kernels";
+  }
+  static constexpr const char* kinds[] = {"substring", "prefix", "glob", "regex"};
+  std::string text;
+  for (const auto* rules : {&includes_, &excludes_}) {
+    for (const auto& r : *rules) {
+      text += fmt::format("{}{}{} '{}'",
+                          text.empty() ? "" : ", ",
+                          rules == &excludes_ ? "exclude " : "",
+                          kinds[static_cast<int>(r.type)],
+                          r.pattern);
+    }
+  }
+  return text;
+}
+
+}  // namespace maestro
@@ -0,0 +1,78 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace maestro {
+
+// KERNEL_TO_TRACE compiled into match rules. The value is a ';'-separated
+// list of patterns matched against demangled kernel names:
+//
+//   name        substring match (the historical behavior)
+//   name*       prefix match; other '*' / '?' patterns are globs
+//   re:expr     ECMAScript regex search
+//   !pattern    exclude kernels matching any of the above forms
+//
+// A kernel is traced when it matches an include pattern (or there are none)
+// and no exclude pattern. An unset KERNEL_TO_TRACE traces every kernel; a set
+// one without any pattern, such as "", traces none.
+class kernel_filter {
+ public:
+  explicit kernel_filter(const char* spec);
+
+  bool matches(std::string_view name) const;
+
+  // True when every kernel is traced
+  bool traces_all() const { return !none_ && includes_.empty() && excludes_.empty(); }
+  std::string describe() const;
+
+ private:
+  enum struct kind {
+    SUBSTRING,
+    PREFIX,
+    GLOB,
+    REGEX,
+  };
+
+  struct rule {
+    kind type;
+    std::string pattern;
+    std::regex regex;
+
+    bool matches(std::string_view name) const;
+  };
+
+  static rule compile(std::string_view token);
+
+  std::vector<rule> includes_;
+  std::vector<rule> excludes_;
+  bool none_{false};
+};
+
+}  // namespace maestro
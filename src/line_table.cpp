@@ -0,0 +1,120 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "line_table.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace maestro {
+
+namespace {
+std::size_t slot_of(std::uint64_t key, std::size_t mask) {
+  // Fibonacci hashing spreads consecutive line numbers over the table
+  return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+}  // namespace
+
+void line_table::grow() {
+  const auto size = std::max<std::size_t>(keys_.size() * 2, 64);
+  std::vector<std::uint64_t> keys(size, 0);
+  std::vector<std::uint32_t> values(size, 0);
+  const auto mask = size - 1;
+  for (std::size_t i = 0; i < keys_.size(); i++) {
+    if (keys_[i]) {
+      auto slot = slot_of(keys_[i], mask);
+      while (keys[slot]) {
+        slot = (slot + 1) & mask;
+      }
+      keys[slot] = keys_[i];
+      values[slot] = values_[i];
+    }
+  }
+  keys_ = std::move(keys);
+  values_ = std::move(values);
+}
+
+std::uint32_t line_table::find_or_insert(std::uint64_t key) {
+  if (2 * (lines_.size() + 1) > keys_.size()) {
+    grow();
+  }
+  const auto mask = keys_.size() - 1;
+  auto slot = slot_of(key, mask);
+  for (; keys_[slot]; slot = (slot + 1) & mask) {
+    if (keys_[slot] == key) {
+      return values_[slot];
+    }
+  }
+  const auto index = static_cast<std::uint32_t>(lines_.size());
+  keys_[slot] = key;
+  values_[slot] = index;
+  const auto pair = key - 1;
+  lines_.push_back({static_cast<std::uint32_t>(pair >> 32),
+                    static_cast<std::uint32_t>(pair)});
+  return index;
+}
+
+std::uint32_t line_table::add_file(const std::string& name) {
+  auto [it, inserted] =
+      file_ids_.try_emplace(name, static_cast<std::uint32_t>(files_.size()));
+  if (inserted) {
+    files_.push_back(name);
+  }
+  return it->second;
+}
+
+void line_table::add(std::uint32_t file, std::uint32_t line) {
+  if (!line) {
+    source_index_.push_back(no_source);
+    return;
+  }
+  const auto key = (static_cast<std::uint64_t>(file) << 32 | line) + 1;
+  source_index_.push_back(static_cast<std::int32_t>(find_or_insert(key)));
+}
+
+void line_table::finish() {
+  // lines_ is in first-use order, so a stable sort keeps it within a line
+  std::vector<std::uint32_t> order(lines_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](auto a, auto b) {
+    return lines_[a].line < lines_[b].line;
+  });
+
+  std::vector<std::int32_t> remap(lines_.size());
+  std::vector<source_line> sorted(lines_.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    remap[order[i]] = static_cast<std::int32_t>(i);
+    sorted[i] = lines_[order[i]];
+  }
+  lines_ = std::move(sorted);
+  for (auto& index : source_index_) {
+    if (index != no_source) {
+      index = remap[index];
+    }
+  }
+  keys_ = {};
+  values_ = {};
+}
+
+}  // namespace maestro
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace maestro {
+
+// Source attribution of one kernel, built in a single pass over its
+// instructions in basic block order. Every distinct (file, line) pair is kept
+// once, and each instruction points at its pair through source_index(), so
+// per-line attribution needs no lookups after the pass.
+class line_table {
+ public:
+  // source_index() value of an instruction without debug info
+  static constexpr std::int32_t no_source = -1;
+
+  struct source_line {
+    std::uint32_t file;
+    std::uint32_t line;
+  };
+
+  // Returns the id of a file name, so that debug info entries naming the same
+  // file share their lines
+  std::uint32_t add_file(const std::string& name);
+
+  // Records the next instruction. Line 0 means no source location.
+  void add(std::uint32_t file, std::uint32_t line);
+
+  // Orders the distinct lines by line number, then by first use, and remaps
+  // the instruction indices. Call once after the last add().
+  void finish();
+
+  const std::vector<std::string>& files() const { return files_; }
+  const std::vector<source_line>& lines() const { return lines_; }
+  // Index into lines() per instruction, or no_source
+  const std::vector<std::int32_t>& source_index() const { return source_index_; }
+
+ private:
+  std::uint32_t find_or_insert(std::uint64_t key);
+  void grow();
+
+  // Open addressing on (file << 32 | line) + 1; zero marks an empty slot
+  std::vector<std::uint64_t> keys_;
+  std::vector<std::uint32_t> values_;
+  std::vector<std::string> files_;
+  std::unordered_map<std::string, std::uint32_t> file_ids_;
+  std::vector<source_line> lines_;
+  std::vector<std::int32_t> source_index_;
+};
+
+}  // namespace maestro
@@ -26,15 +26,16 @@
 
 #include <fmt/core.h>
 #include <unistd.h>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include "log_sink.hpp"
 
 extern "C" {
 extern char** environ;
@@ -44,22 +45,18 @@ namespace maestro {
 
 namespace detail {
 
-inline std::string get_relative_path(const char* file) {
-  namespace fs = std::filesystem;
-
-  fs::path file_path = file;
-  for (auto it = file_path.begin(); it != file_path.end(); ++it) {
-    if (*it == "src") {
-      fs::path base_path;
-      for (auto iter = file_path.begin(); iter != it; ++iter) {
-        base_path /= *iter;
-      }
-
-      return fs::relative(file_path, base_path).string();
+// Strips everything before the first "src" component of __FILE__. Evaluated
+// at compile time so call sites only carry a pointer into the literal.
+consteval const char* get_relative_path(const char* file) {
+  const char* result = file;
+  for (const char* p = file; *p; ++p) {
+    const bool at_component = p == file || *(p - 1) == '/';
+    if (at_component && p[0] == 's' && p[1] == 'r' && p[2] == 'c' &&
+        (p[3] == '/' || p[3] == '\0')) {
+      return p;
     }
   }
-
-  return file;
+  return result;
 }
 
 inline bool supports_colors() {
@@ -111,61 +108,73 @@ constexpr auto log_level_to_string(const LogLevel level) {
   }
 }
 
+inline int log_level() {
+  static const int level = [] {
+    const char* log_env = std::getenv("NEXUS_LOG_LEVEL");
+    return log_env ? std::atoi(log_env) : +LogLevel::NONE;
+  }();
+  return level;
+}
+
+inline bool log_enabled(const LogLevel level) {
+  return log_level() >= +level;
+}
+
 template <typename... Args>
-inline void log_message(const LogLevel level,
-                        const std::string& file,
-                        int line,
-                        const char* msg,
-                        Args... args) {
-  static const char* log_env = std::getenv("NEXUS_LOG_LEVEL");
-  if (log_env) {
-    static auto log_level_env = std::atoi(log_env);
-
-    if (log_level_env >= +level) {
-      const char* color_reset = "\033[0m";
-      const char* color_info = "\033[37m";
-      const char* color_warn = "\033[33m";
-      const char* color_error = "\033[31m";
-
-      if (!supports_colors()) {
-        color_reset = "";
-        color_info = "";
-        color_warn = "";
-        color_error = "";
-      }
-
-      const char* color = color_info;
-      if (level == LogLevel::ERROR) {
-        color = color_error;
-      } else if (level == LogLevel::WARN) {
-        color = color_warn;
-      }
-
-      std::string formatted_message;
-      if constexpr (sizeof...(args) > 0) {
-        formatted_message = fmt::vformat(msg, fmt::make_format_args(args...));
-      } else {
-        formatted_message = msg;
-      }
-
-      std::printf("%s[%s]: [%s:%d] %s%s\n",
-                  color,
-                  log_level_to_string(level),
-                  file.c_str(),
-                  line,
-                  formatted_message.c_str(),
-                  color_reset);
-
-      static const char* log_file = std::getenv("NEXUS_LOG_FILE");
-      if (log_file) {
-        static std::ofstream log_stream(log_file, std::ios::app);
-        if (log_stream) {
-          std::ostringstream oss;
-          oss << log_level_to_string(level) << ": [" << file.c_str() << ":" << line
-              << "] " << formatted_message << "\n";
-          log_stream << oss.str();
-        }
-      }
+void log_message(std::uint32_t format_id,
+                 const LogLevel level,
+                 const char* file,
+                 int line,
+                 const char* msg,
+                 const Args&... args) {
+  if (auto* sink = log_sink::get()) {
+    sink->write(format_id, loggable(args)...);
+    return;
+  }
+
+  const char* color_reset = "\033[0m";
+  const char* color_info = "\033[37m";
+  const char* color_warn = "\033[33m";
+  const char* color_error = "\033[31m";
+
+  static const bool colors = supports_colors();
+  if (!colors) {
+    color_reset = "";
+    color_info = "";
+    color_warn = "";
+    color_error = "";
+  }
+
+  const char* color = color_info;
+  if (level == LogLevel::ERROR) {
+    color = color_error;
+  } else if (level == LogLevel::WARN) {
+    color = color_warn;
+  }
+
+  std::string formatted_message;
+  if constexpr (sizeof...(args) > 0) {
+    formatted_message = fmt::vformat(msg, fmt::make_format_args(args...));
+  } else {
+    formatted_message = msg;
+  }
+
+  std::printf("%s[%s]: [%s:%d] %s%s\n",
+              color,
+              log_level_to_string(level),
+              file,
+              line,
+              formatted_message.c_str(),
+              color_reset);
+
+  static const char* log_file = std::getenv("NEXUS_LOG_FILE");
+  if (log_file) {
+    static std::ofstream log_stream(log_file, std::ios::app);
+    if (log_stream) {
+      std::ostringstream oss;
+      oss << log_level_to_string(level) << ": [" << file << ":" << line << "] "
+          << formatted_message << "\n";
+      log_stream << oss.str();
     }
   }
 }
@@ -173,30 +182,39 @@ inline void log_message(const LogLevel level,
 }  // namespace detail
 }  // namespace maestro
 
-#define LOG_DETAIL(msg, ...)                                                 \
-  maestro::detail::log_message(maestro::detail::LogLevel::DETAIL,            \
-                               maestro::detail::get_relative_path(__FILE__), \
-                               __LINE__,                                     \
-                               msg,                                          \
-                               ##__VA_ARGS__)
-
-#define LOG_INFO(msg, ...)                                                   \
-  maestro::detail::log_message(maestro::detail::LogLevel::INFO,              \
-                               maestro::detail::get_relative_path(__FILE__), \
-                               __LINE__,                                     \
-                               msg,                                          \
-                               ##__VA_ARGS__)
-
-#define LOG_WARN(msg, ...)                                                   \
-  maestro::detail::log_message(maestro::detail::LogLevel::WARN,              \
-                               maestro::detail::get_relative_path(__FILE__), \
-                               __LINE__,                                     \
-                               msg,                                          \
-                               ##__VA_ARGS__)
-
-#define LOG_ERROR(msg, ...)                                                  \
-  maestro::detail::log_message(maestro::detail::LogLevel::ERROR,             \
-                               maestro::detail::get_relative_path(__FILE__), \
-                               __LINE__,                                     \
-                               msg,                                          \
-                               ##__VA_ARGS__)
+// Levels above NEXUS_MIN_LOG_LEVEL are compiled out entirely. The runtime
+// level is checked before any argument is evaluated.
+#ifndef NEXUS_MIN_LOG_LEVEL
+#define NEXUS_MIN_LOG_LEVEL 4
+#endif
+
+#define NEXUS_LOG(level, msg, ...)                                              \
+  do {                                                                          \
+    if constexpr (+(level) <= NEXUS_MIN_LOG_LEVEL) {                            \
+      if (maestro::detail::log_enabled(level)) {                                \
+        static constexpr const char* nexus_log_file_ =                          \
+            maestro::detail::get_relative_path(__FILE__);                       \
+        static const std::uint32_t nexus_log_id_ =                              \
+            maestro::detail::log_sink::register_format(+(level),                \
+                                                       nexus_log_file_,         \
+                                                       __LINE__,                \
+                                                       msg);                    \
+        maestro::detail::log_message(nexus_log_id_,                             \
+                                     level,                                     \
+                                     nexus_log_file_,                           \
+                                     __LINE__,                                  \
+                                     msg,                                       \
+                                     ##__VA_ARGS__);                            \
+      }                                                                         \
+    }                                                                           \
+  } while (0)
+
+#define LOG_DETAIL(msg, ...) \
+  NEXUS_LOG(maestro::detail::LogLevel::DETAIL, msg, ##__VA_ARGS__)
+
+#define LOG_INFO(msg, ...) NEXUS_LOG(maestro::detail::LogLevel::INFO, msg, ##__VA_ARGS__)
+
+#define LOG_WARN(msg, ...) NEXUS_LOG(maestro::detail::LogLevel::WARN, msg, ##__VA_ARGS__)
+
+#define LOG_ERROR(msg, ...) \
+  NEXUS_LOG(maestro::detail::LogLevel::ERROR, msg, ##__VA_ARGS__)
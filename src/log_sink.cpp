@@ -0,0 +1,382 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "log_sink.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+
+#if __has_include(<fmt/args.h>)
+#include <fmt/args.h>
+#endif
+
+#include "log.hpp"
+
+namespace maestro {
+namespace detail {
+
+namespace {
+
+// Call sites in registration order; the index is the format id. A deque keeps
+// references stable while the writer thread reads older entries.
+std::mutex formats_mutex;
+std::deque<log_format> formats;
+
+std::atomic<log_sink*> active_sink{nullptr};
+
+std::size_t round_up_pow2(std::size_t n) {
+  std::size_t result = 4096;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// The ring of the calling thread. These two are trivially destructible, so
+// LOG_* from thread_local destructors that run after the owner's still reads
+// them safely; such records are dropped.
+thread_local log_ring* thread_ring = nullptr;
+thread_local bool thread_exiting = false;
+
+struct ring_owner {
+  bool armed{false};
+
+  ~ring_owner() {
+    if (thread_ring) {
+      thread_ring->retire();
+      thread_ring = nullptr;
+    }
+    thread_exiting = true;
+  }
+};
+thread_local ring_owner thread_ring_owner;
+
+template <typename T>
+T read_value(const std::byte*& p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+}  // namespace
+
+log_ring::log_ring(std::size_t capacity, std::uint32_t thread_id)
+    : buffer_(new std::byte[round_up_pow2(capacity)]),
+      mask_(round_up_pow2(capacity) - 1),
+      thread_id_(thread_id) {}
+
+std::byte* log_ring::reserve(std::size_t size) {
+  const auto capacity = mask_ + 1;
+  auto head = head_.load(std::memory_order_relaxed);
+  const auto contiguous = capacity - (head & mask_);
+  const auto needed = size + (contiguous < size ? contiguous : 0);
+
+  if (size > capacity / 2) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  if (head + needed - cached_tail_ > capacity) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head + needed - cached_tail_ > capacity) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  if (contiguous < size) {
+    auto* padding = reinterpret_cast<log_record*>(&buffer_[head & mask_]);
+    padding->size = static_cast<std::uint32_t>(contiguous);
+    padding->format_id = log_padding_id;
+    head += contiguous;
+  }
+  pending_ = head;
+  return &buffer_[head & mask_];
+}
+
+log_sink* log_sink::get() {
+  static const bool started = [] {
+    const char* async_env = std::getenv("NEXUS_LOG_ASYNC");
+    const char* binary_path = std::getenv("NEXUS_LOG_BINARY");
+    if (!binary_path && !(async_env && std::atoi(async_env) != 0)) {
+      return false;
+    }
+
+    std::FILE* binary = nullptr;
+    if (binary_path) {
+      binary = std::fopen(binary_path, "wb");
+      if (!binary) {
+        std::fprintf(stderr, "nexus: cannot open binary log %s\n", binary_path);
+        return false;
+      }
+      std::fwrite(log_file_magic, 1, sizeof(log_file_magic), binary);
+    }
+
+    const char* ring_env = std::getenv("NEXUS_LOG_RING_KB");
+    const std::size_t ring_kb = ring_env ? std::atoi(ring_env) : 1024;
+
+    // Never destroyed: LOG_* may run from static destructors
+    active_sink.store(new log_sink(binary, ring_kb << 10), std::memory_order_release);
+    std::atexit(log_sink::shutdown);
+    return true;
+  }();
+  (void)started;
+  return active_sink.load(std::memory_order_acquire);
+}
+
+std::uint32_t log_sink::register_format(int level,
+                                        const char* file,
+                                        int line,
+                                        const char* msg) {
+  std::lock_guard g(formats_mutex);
+  formats.push_back({level, file, line, msg});
+  return static_cast<std::uint32_t>(formats.size() - 1);
+}
+
+void log_sink::shutdown() {
+  auto* sink = active_sink.exchange(nullptr, std::memory_order_acq_rel);
+  if (!sink) {
+    return;
+  }
+  {
+    std::lock_guard g(sink->wake_mutex_);
+    sink->stop_ = true;
+  }
+  sink->wake_.notify_one();
+  sink->thread_.join();
+  sink->flush();
+  if (sink->binary_) {
+    std::fclose(sink->binary_);
+    sink->binary_ = nullptr;
+  }
+}
+
+std::string log_sink::format(const char* msg, const log_record& record) {
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+  const auto* p = reinterpret_cast<const std::byte*>(&record) + sizeof(log_record);
+  for (std::uint32_t i = 0; i < record.num_args; i++) {
+    switch (static_cast<log_arg>(*p++)) {
+      case log_arg::I64:
+        store.push_back(read_value<std::int64_t>(p));
+        break;
+      case log_arg::U64:
+        store.push_back(read_value<std::uint64_t>(p));
+        break;
+      case log_arg::F64:
+        store.push_back(read_value<double>(p));
+        break;
+      case log_arg::BOOL:
+        store.push_back(read_value<std::uint64_t>(p) != 0);
+        break;
+      case log_arg::CHAR:
+        store.push_back(static_cast<char>(read_value<std::uint64_t>(p)));
+        break;
+      case log_arg::PTR:
+        store.push_back(reinterpret_cast<const void*>(read_value<std::uint64_t>(p)));
+        break;
+      case log_arg::STR: {
+        const auto length = read_value<std::uint32_t>(p);
+        store.push_back(std::string(reinterpret_cast<const char*>(p), length));
+        p += length;
+        break;
+      }
+    }
+  }
+  try {
+    return fmt::vformat(msg, store);
+  } catch (const std::exception& e) {
+    return fmt::format("{} <format error: {}>", msg, e.what());
+  }
+}
+
+log_sink::log_sink(std::FILE* binary, std::size_t ring_size)
+    : binary_(binary), ring_size_(ring_size) {
+  const char* log_file = std::getenv("NEXUS_LOG_FILE");
+  if (!binary_ && log_file) {
+    text_ = std::fopen(log_file, "a");
+  }
+  thread_ = std::thread([this]() { run(); });
+}
+
+log_ring* log_sink::local_ring() {
+  if (!thread_ring && !thread_exiting) {
+    const auto tid = static_cast<std::uint32_t>(::syscall(SYS_gettid));
+    auto owned = std::make_shared<log_ring>(ring_size_, tid);
+    // Constructs the owner, which retires the ring at thread exit
+    thread_ring_owner.armed = true;
+    thread_ring = owned.get();
+    std::lock_guard g(rings_mutex_);
+    rings_.push_back(std::move(owned));
+  }
+  return thread_ring;
+}
+
+std::uint64_t log_sink::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void log_sink::run() {
+  const char* flush_env = std::getenv("NEXUS_LOG_FLUSH_MS");
+  const auto interval = std::chrono::milliseconds(flush_env ? std::atoi(flush_env) : 10);
+  std::unique_lock lock(wake_mutex_);
+  while (!stop_) {
+    wake_.wait_for(lock, interval, [this] { return stop_; });
+    lock.unlock();
+    flush();
+    lock.lock();
+  }
+}
+
+void log_sink::flush() {
+  std::lock_guard flush_lock(flush_mutex_);
+
+  std::vector<std::shared_ptr<log_ring>> rings;
+  {
+    std::lock_guard g(rings_mutex_);
+    rings = rings_;
+  }
+
+  // Records of one batch are merged across threads by timestamp
+  std::vector<std::byte> batch;
+  std::vector<std::pair<std::uint64_t, std::size_t>> order;
+  std::uint64_t dropped = 0;
+  std::vector<const log_ring*> retired;
+  for (const auto& ring : rings) {
+    // Checked before draining: a retired ring gets no more records
+    const bool exited = ring->retired();
+    ring->drain([&](const log_record& record) {
+      order.emplace_back(record.timestamp, batch.size());
+      const auto* bytes = reinterpret_cast<const std::byte*>(&record);
+      batch.insert(batch.end(), bytes, bytes + record.size);
+    });
+    if (exited) {
+      retired.push_back(ring.get());
+      retired_dropped_ += ring->dropped();
+    } else {
+      dropped += ring->dropped();
+    }
+  }
+  dropped += retired_dropped_ + late_dropped_.load(std::memory_order_relaxed);
+  if (!retired.empty()) {
+    std::lock_guard g(rings_mutex_);
+    std::erase_if(rings_, [&](const auto& ring) {
+      return std::find(retired.begin(), retired.end(), ring.get()) != retired.end();
+    });
+  }
+  rings.clear();
+  std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  std::unique_lock formats_lock(formats_mutex);
+  if (binary_) {
+    const auto definitions = static_cast<std::uint32_t>(formats.size());
+    for (; formats_written_ < definitions; formats_written_++) {
+      const auto& f = formats[formats_written_];
+      const auto file_length = static_cast<std::uint32_t>(std::strlen(f.file));
+      const auto msg_length = static_cast<std::uint32_t>(std::strlen(f.msg));
+      const auto size = log_align(7 * sizeof(std::uint32_t) + file_length + msg_length);
+      const std::uint32_t fields[7] = {static_cast<std::uint32_t>(size),
+                                       log_definition_id,
+                                       formats_written_,
+                                       static_cast<std::uint32_t>(f.level),
+                                       static_cast<std::uint32_t>(f.line),
+                                       file_length,
+                                       msg_length};
+      std::vector<std::byte> entry(size);
+      std::memcpy(entry.data(), fields, sizeof(fields));
+      std::memcpy(entry.data() + sizeof(fields), f.file, file_length);
+      std::memcpy(entry.data() + sizeof(fields) + file_length, f.msg, msg_length);
+      std::fwrite(entry.data(), 1, entry.size(), binary_);
+    }
+    formats_lock.unlock();
+    for (const auto& [timestamp, offset] : order) {
+      const auto* record = reinterpret_cast<const log_record*>(&batch[offset]);
+      std::fwrite(record, 1, record->size, binary_);
+    }
+    std::fflush(binary_);
+    if (dropped > dropped_reported_) {
+      std::fprintf(stderr,
+                   "nexus: %llu log records dropped (ring full or thread exiting)\n",
+                   static_cast<unsigned long long>(dropped - dropped_reported_));
+      dropped_reported_ = dropped;
+    }
+    return;
+  }
+
+  static const bool colors = supports_colors();
+  std::string screen;
+  std::string file;
+  for (const auto& [timestamp, offset] : order) {
+    const auto* record = reinterpret_cast<const log_record*>(&batch[offset]);
+    const auto& f = formats[record->format_id];
+    const auto level = static_cast<LogLevel>(f.level);
+    const auto message = format(f.msg, *record);
+    const char* color = "";
+    if (colors) {
+      color = level == LogLevel::ERROR  ? "\033[31m"
+              : level == LogLevel::WARN ? "\033[33m"
+                                        : "\033[37m";
+    }
+    screen += fmt::format("{}[{}]: [{}:{}] {}{}\n",
+                          color,
+                          log_level_to_string(level),
+                          f.file,
+                          f.line,
+                          message,
+                          colors ? "\033[0m" : "");
+    if (text_) {
+      file += fmt::format("{}: [{}:{}] {}\n",
+                          log_level_to_string(level),
+                          f.file,
+                          f.line,
+                          message);
+    }
+  }
+  if (dropped > dropped_reported_) {
+    screen +=
+        fmt::format("[WARN]: {} log records dropped (ring full or thread exiting)\n",
+                    dropped - dropped_reported_);
+    dropped_reported_ = dropped;
+  }
+  formats_lock.unlock();
+
+  if (!screen.empty()) {
+    std::fwrite(screen.data(), 1, screen.size(), stdout);
+    std::fflush(stdout);
+  }
+  if (text_ && !file.empty()) {
+    std::fwrite(file.data(), 1, file.size(), text_);
+    std::fflush(text_);
+  }
+}
+
+}  // namespace detail
+}  // namespace maestro
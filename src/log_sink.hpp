@@ -0,0 +1,271 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <fmt/core.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace maestro {
+namespace detail {
+
+// A LOG_* call site, registered the first time it fires.
+struct log_format {
+  int level;
+  const char* file;
+  int line;
+  const char* msg;
+};
+
+enum struct log_arg : std::uint8_t {
+  I64,
+  U64,
+  F64,
+  BOOL,
+  CHAR,
+  PTR,
+  STR,
+};
+
+// Header of a record, both in the per-thread rings and in binary log files.
+// Arguments follow as a tag byte and a raw value (strings: u32 length + bytes).
+struct log_record {
+  std::uint32_t size;  // header included, multiple of 8
+  std::uint32_t format_id;
+  std::uint64_t timestamp;  // ns since epoch
+  std::uint32_t thread_id;
+  std::uint32_t num_args;
+};
+
+// Special format ids. A definition entry carries u32 id, i32 level, i32 line,
+// u32 file length, u32 msg length, then both strings.
+inline constexpr std::uint32_t log_padding_id = UINT32_MAX;
+inline constexpr std::uint32_t log_definition_id = UINT32_MAX - 1;
+inline constexpr char log_file_magic[8] = {'N', 'X', 'L', 'O', 'G', '0', '0', '1'};
+
+inline constexpr std::size_t log_align(std::size_t size) {
+  return (size + 7) & ~std::size_t{7};
+}
+
+// Single-producer, single-consumer byte ring. Records never wrap: when one
+// does not fit before the end, the tail is filled with a padding entry.
+class log_ring {
+ public:
+  explicit log_ring(std::size_t capacity, std::uint32_t thread_id);
+
+  std::byte* reserve(std::size_t size);
+  void commit(std::size_t size) {
+    head_.store(pending_ + size, std::memory_order_release);
+  }
+
+  // Calls f(const log_record&) for every committed record
+  template <typename F>
+  void drain(F&& f) {
+    const auto head = head_.load(std::memory_order_acquire);
+    auto tail = tail_.load(std::memory_order_relaxed);
+    while (tail != head) {
+      const auto* record = reinterpret_cast<const log_record*>(&buffer_[tail & mask_]);
+      if (record->format_id != log_padding_id) {
+        f(*record);
+      }
+      tail += record->size;
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  std::uint32_t thread_id() const { return thread_id_; }
+  std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // Called by the owning thread as it exits; the flusher frees the ring once
+  // it has drained it
+  void retire() { retired_.store(true, std::memory_order_release); }
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+ private:
+  std::unique_ptr<std::byte[]> buffer_;
+  std::size_t mask_;
+  std::uint32_t thread_id_;
+  alignas(64) std::atomic<std::uint64_t> head_{0};
+  std::uint64_t pending_{0};
+  std::uint64_t cached_tail_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<bool> retired_{false};
+  alignas(64) std::atomic<std::uint64_t> tail_{0};
+};
+
+template <typename T>
+constexpr bool is_log_string =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+template <typename T>
+constexpr bool is_log_scalar =
+    std::is_arithmetic_v<T> || (std::is_pointer_v<T> && !is_log_string<T>);
+
+// Scalars and strings are copied into the record as-is; anything else is
+// formatted on the calling thread.
+template <typename T>
+decltype(auto) loggable(const T& value) {
+  using U = std::decay_t<const T&>;
+  if constexpr (is_log_scalar<U> || std::is_pointer_v<U>) {
+    return static_cast<U>(value);
+  } else if constexpr (is_log_string<U>) {
+    return static_cast<const U&>(value);
+  } else {
+    return fmt::format("{}", value);
+  }
+}
+
+template <typename T>
+std::size_t encoded_size(const T& value) {
+  if constexpr (is_log_string<T>) {
+    return 1 + sizeof(std::uint32_t) + std::string_view(value).size();
+  } else {
+    return 1 + sizeof(std::uint64_t);
+  }
+}
+
+template <typename T>
+void encode(std::byte*& out, const T& value) {
+  const auto put = [&out](log_arg tag, const void* data, std::size_t size) {
+    *out++ = static_cast<std::byte>(tag);
+    std::memcpy(out, data, size);
+    out += size;
+  };
+  if constexpr (is_log_string<T>) {
+    const std::string_view view(value);
+    const auto length = static_cast<std::uint32_t>(view.size());
+    *out++ = static_cast<std::byte>(log_arg::STR);
+    std::memcpy(out, &length, sizeof(length));
+    std::memcpy(out + sizeof(length), view.data(), view.size());
+    out += sizeof(length) + view.size();
+  } else if constexpr (std::is_same_v<T, bool>) {
+    const std::uint64_t v = value;
+    put(log_arg::BOOL, &v, sizeof(v));
+  } else if constexpr (std::is_same_v<T, char>) {
+    const std::uint64_t v = static_cast<unsigned char>(value);
+    put(log_arg::CHAR, &v, sizeof(v));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    const double v = value;
+    put(log_arg::F64, &v, sizeof(v));
+  } else if constexpr (std::is_pointer_v<T>) {
+    const auto v = reinterpret_cast<std::uint64_t>(value);
+    put(log_arg::PTR, &v, sizeof(v));
+  } else if constexpr (std::is_signed_v<T>) {
+    const std::int64_t v = value;
+    put(log_arg::I64, &v, sizeof(v));
+  } else {
+    const std::uint64_t v = value;
+    put(log_arg::U64, &v, sizeof(v));
+  }
+}
+
+// Asynchronous log backend. Call sites encode their arguments into a ring
+// owned by the calling thread; a background thread formats (or, in binary
+// mode, copies) the records and flushes them in batches.
+//
+// NEXUS_LOG_ASYNC=1 enables it with text output, NEXUS_LOG_BINARY=<path>
+// writes binary records to <path> instead (see tools/nexus_log_decode).
+class log_sink {
+ public:
+  // The active sink, or nullptr when logging is synchronous
+  static log_sink* get();
+
+  static std::uint32_t register_format(int level,
+                                       const char* file,
+                                       int line,
+                                       const char* msg);
+
+  // Drains every ring and switches back to synchronous logging
+  static void shutdown();
+
+  // Formats a record's arguments with the call site's format string
+  static std::string format(const char* msg, const log_record& record);
+
+  template <typename... Args>
+  void write(std::uint32_t format_id, const Args&... args) {
+    const auto size = log_align(sizeof(log_record) + (std::size_t{0} + ... +
+                                                      encoded_size(args)));
+    log_ring* ring = local_ring();
+    if (!ring) {
+      late_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    auto* out = ring->reserve(size);
+    if (!out) {
+      return;
+    }
+    auto* record = reinterpret_cast<log_record*>(out);
+    record->size = static_cast<std::uint32_t>(size);
+    record->format_id = format_id;
+    record->timestamp = now();
+    record->thread_id = ring->thread_id();
+    record->num_args = sizeof...(args);
+    out += sizeof(log_record);
+    (encode(out, args), ...);
+    ring->commit(size);
+  }
+
+ private:
+  log_sink(std::FILE* binary, std::size_t ring_size);
+
+  // The calling thread's ring; nullptr once the thread is exiting
+  log_ring* local_ring();
+  static std::uint64_t now();
+  void run();
+  void flush();
+
+  std::FILE* binary_;
+  std::FILE* text_{nullptr};
+  std::size_t ring_size_;
+  std::uint32_t formats_written_{0};
+  std::uint64_t dropped_reported_{0};
+  // Dropped records of freed rings, and of threads that logged while exiting
+  std::uint64_t retired_dropped_{0};
+  std::atomic<std::uint64_t> late_dropped_{0};
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<log_ring>> rings_;  // of live threads, or not drained
+
+  std::mutex flush_mutex_;
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace detail
+}  // namespace maestro
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "mapping_index.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+
+#include "log.hpp"
+
+namespace maestro {
+
+static std::string read_proc_file(const char* path) {
+  std::string contents;
+  const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return contents;
+  }
+  // procfs files report a size of zero, so read until EOF
+  char buffer[64 * 1024];
+  ssize_t n;
+  while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+    contents.append(buffer, static_cast<std::size_t>(n));
+  }
+  ::close(fd);
+  return contents;
+}
+
+std::vector<mapping_index::mapping> mapping_index::parse(std::string_view maps) {
+  std::vector<mapping> result;
+  result.reserve(maps.size() / 100);
+
+  while (!maps.empty()) {
+    const auto eol = maps.find('\n');
+    std::string_view line = maps.substr(0, eol);
+    maps.remove_prefix(eol == std::string_view::npos ? maps.size() : eol + 1);
+
+    // start-end perms offset dev inode [path]
+    const char* p = line.data();
+    const char* last = line.data() + line.size();
+    std::uintptr_t start = 0;
+    std::uintptr_t end = 0;
+    auto [dash, ec] = std::from_chars(p, last, start, 16);
+    if (ec != std::errc() || dash == last || *dash != '-') {
+      continue;
+    }
+    auto [after, ec2] = std::from_chars(dash + 1, last, end, 16);
+    if (ec2 != std::errc()) {
+      continue;
+    }
+
+    // Skip the address range and the four fields that follow it
+    p = after;
+    for (int field = 0; field < 4 && p < last; field++) {
+      while (p < last && *p == ' ') {
+        p++;
+      }
+      while (p < last && *p != ' ') {
+        p++;
+      }
+    }
+    while (p < last && (*p == ' ' || *p == '\t')) {
+      p++;
+    }
+
+    result.push_back({start, end, std::string(p, last)});
+  }
+
+  // The kernel already lists mappings in address order
+  if (!std::is_sorted(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.start < b.start;
+      })) {
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+      return a.start < b.start;
+    });
+  }
+  return result;
+}
+
+const mapping_index::mapping* mapping_index::lookup_locked(
+    std::uintptr_t address) const {
+  auto it = std::upper_bound(
+      mappings_.begin(), mappings_.end(), address, [](std::uintptr_t a, const auto& m) {
+        return a < m.start;
+      });
+  if (it == mappings_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return address < it->end ? &*it : nullptr;
+}
+
+void mapping_index::refresh_locked() {
+  mappings_ = parse(read_proc_file("/proc/self/maps"));
+  LOG_DETAIL("Indexed {} memory mappings", mappings_.size());
+}
+
+std::optional<std::string> mapping_index::find(std::uintptr_t address) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto* hit = lookup_locked(address);
+  if (!hit) {
+    refresh_locked();
+    hit = lookup_locked(address);
+  }
+  if (!hit || hit->path == "[heap]") {
+    return {};
+  }
+  return hit->path.empty() ? "[anonymous mapping]" : hit->path;
+}
+
+}  // namespace maestro
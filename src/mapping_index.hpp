@@ -0,0 +1,66 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace maestro {
+
+// Sorted interval table over /proc/self/maps. The table is only re-read when
+// an address falls outside every known mapping.
+class mapping_index {
+ public:
+  // Path of the mapping that contains `address`, "[anonymous mapping]" for
+  // mappings without a path, or nullopt for the heap and unmapped addresses.
+  std::optional<std::string> find(std::uintptr_t address);
+
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mappings_.size();
+  }
+
+  struct mapping {
+    std::uintptr_t start;
+    std::uintptr_t end;
+    std::string path;
+  };
+
+  // Parses the contents of a maps file into a table sorted by start address
+  static std::vector<mapping> parse(std::string_view maps);
+
+ private:
+  const mapping* lookup_locked(std::uintptr_t address) const;
+  void refresh_locked();
+
+  mutable std::mutex mutex_;
+  std::vector<mapping> mappings_;
+};
+
+}  // namespace maestro
@@ -39,180 +39,425 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <optional>
-#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 namespace maestro {
 
 std::mutex nexus::mutex_{};
-std::shared_mutex nexus::stop_mutex_{};
-nexus* nexus::singleton_{nullptr};
-
-static std::optional<std::string> find_file_path(const std::string& filename) {
-  auto try_open = [](const std::string& path) -> bool {
-    std::ifstream f(path);
-    return f.good();
-  };
-
-  // 1. Try original path
-  if (try_open(filename)) {
-    return filename;
+std::atomic<nexus*> nexus::singleton_{nullptr};
+
+static std::string read_line_from_file(const source_file& file,
+                                      const std::string& full_path,
+                                      size_t line_number) {
+  const auto line = file.line(line_number);
+  if (!line) {
+    LOG_WARN("Line number {} not found in file {}", line_number, full_path);
+    return "";
   }
+  return std::string(*line);
+}
 
-  // 2. Try environment variable search
-  const char* env = std::getenv("NEXUS_EXTRA_SEARCH_PREFIX");
-  if (!env) {
-    LOG_WARN("Cannot open file {} and NEXUS_EXTRA_SEARCH_PREFIX not set", filename);
-    return std::nullopt;
+nexus::nexus(HsaApiTable* table,
+             uint64_t runtime_version,
+             uint64_t failed_tool_count,
+             const char* const* failed_tool_names)
+    : api_table_{table} {
+  const auto attach_start = std::chrono::steady_clock::now();
+  LOG_DETAIL("Saving current APIs.");
+  timed_phase("save_api", [this] { save_hsa_api(); });
+  LOG_DETAIL("Hooking new APIs.");
+  timed_phase("hook_api", [this] { hook_api(); });
+
+  // With fast attach, agents and kernelDB wait for their first user: a code
+  // object, a dispatch or a staged copy
+  const char* fast_attach_env = std::getenv("NEXUS_FAST_ATTACH");
+  fast_attach_ = fast_attach_env && std::atoi(fast_attach_env) != 0;
+  if (!fast_attach_) {
+    ensure_kdb();
   }
 
-  std::string env_str(env);
-  std::stringstream ss(env_str);
-  std::string root;
-  std::filesystem::path target_path(filename);
-  std::string target_stem = target_path.stem().string();
+  // The full dump needs every kernel, so there is nothing to defer
+  const char* eager_env = std::getenv("NEXUS_EAGER_INGEST");
+  eager_ingest_ = std::getenv("NEXUS_KERNELS_DUMP_FILE") != nullptr ||
+                  (eager_env && std::atoi(eager_env) != 0);
 
-  while (std::getline(ss, root, ':')) {
-    if (root.empty())
-      continue;
+  kernel_filter_ = std::make_unique<kernel_filter>(std::getenv("KERNEL_TO_TRACE"));
+  if (!kernel_filter_->traces_all()) {
+    LOG_INFO("Kernel filter: {}", kernel_filter_->describe());
+  }
 
-    if (root.back() == '*') {
-      // Recursive search
-      std::string base = root.substr(0, root.size() - 1);
-      for (const auto& entry : std::filesystem::recursive_directory_iterator(base)) {
-        if (entry.is_regular_file()) {
-          const auto& entry_path = entry.path();
-          if (entry_path.filename() == filename || entry_path.stem() == target_stem) {
-            if (try_open(entry_path.string())) {
-              return entry_path.string();
-            }
-          }
-        }
-      }
-    } else {
-      // Non-recursive search
-      std::string full_path = root + "/" + filename;
-      if (try_open(full_path)) {
-        return full_path;
-      }
+  const char* env_trace_path = std::getenv("NEXUS_OUTPUT_FILE");
+  if (env_trace_path) {
+    const char* format_env = std::getenv("NEXUS_TRACE_FORMAT");
+    const auto format = format_env && std::string_view(format_env) == "binary"
+                            ? trace_format::BINARY
+                            : trace_format::JSON;
+    trace_writer_ = std::make_unique<trace_writer>(env_trace_path, format);
+  }
+  const char* shared_isa_env = std::getenv("NEXUS_SHARED_ISA");
+  shared_isa_ = shared_isa_env && std::atoi(shared_isa_env) != 0;
+
+  const char* search_prefix = std::getenv("NEXUS_EXTRA_SEARCH_PREFIX");
+  search_index_ = std::make_unique<search_index>(search_prefix);
+
+  // Resolved source text depends on the search paths, so they are part of
+  // every cache key
+  const char* cache_dir = std::getenv("NEXUS_CACHE_DIR");
+  if (cache_dir && *cache_dir) {
+    const char* cache_mb_env = std::getenv("NEXUS_CACHE_MB");
+    const std::uint64_t cache_mb = cache_mb_env ? std::atoi(cache_mb_env) : 1024;
+    cache_ = std::make_unique<extraction_cache>(cache_dir, cache_mb << 20);
+    cache_salt_ = search_prefix ? search_prefix : "";
+    LOG_INFO("Extraction cache: {} ({} MB)", cache_dir, cache_mb);
+  }
 
-      // Check by stem if full_path didn't succeed
-      for (const auto& entry : std::filesystem::directory_iterator(root)) {
-        if (entry.is_regular_file()) {
-          const auto& entry_path = entry.path();
-          if (entry_path.stem() == target_stem) {
-            if (try_open(entry_path.string())) {
-              return entry_path.string();
-            }
+  const char* source_cache_env = std::getenv("NEXUS_SOURCE_CACHE_MB");
+  const std::size_t source_cache_mb =
+      source_cache_env ? std::atoi(source_cache_env) : 256;
+  source_cache_ = std::make_unique<source_cache>(source_cache_mb << 20);
+
+  const char* async_env = std::getenv("NEXUS_ASYNC");
+  if (async_env && std::atoi(async_env) != 0) {
+    const char* workers_env = std::getenv("NEXUS_ASYNC_WORKERS");
+    const char* size_env = std::getenv("NEXUS_ASYNC_QUEUE_SIZE");
+    const char* mode_env = std::getenv("NEXUS_ASYNC_BACKPRESSURE");
+    const char* rate_env = std::getenv("NEXUS_ASYNC_SAMPLE_RATE");
+
+    const std::size_t workers = workers_env ? std::atoi(workers_env) : 1;
+    const std::size_t size = size_env ? std::atoi(size_env) : 4096;
+    const auto mode = parse_backpressure(mode_env ? mode_env : "block");
+    const std::uint32_t rate = rate_env ? std::atoi(rate_env) : 16;
+
+    LOG_INFO("Asynchronous extraction enabled ({} workers, {} records, {} backpressure)",
+             workers,
+             size,
+             mode_env ? mode_env : "block");
+    pipeline_ = std::make_unique<dispatch_pipeline>(
+        [this](const dispatch_record& record) {
+          try {
+            process_dispatch(record);
+          } catch (const std::exception& e) {
+            LOG_ERROR("Processing dispatch threw {}", e.what());
           }
-        }
-      }
-    }
+        },
+        size,
+        workers,
+        mode,
+        rate);
   }
 
-  LOG_WARN("Cannot find file {} in any of the NEXUS_EXTRA_SEARCH_PREFIX paths", filename);
-  return std::nullopt;
-}
+  const char* timing_env = std::getenv("NEXUS_TIMING");
+  if (timing_env && std::atoi(timing_env) != 0) {
+    const char* signals_env = std::getenv("NEXUS_TIMING_SIGNALS");
+    const std::size_t signals = signals_env ? std::atoi(signals_env) : 4096;
+    LOG_INFO("Dispatch timing enabled ({} signals)", signals);
+    timer_ = std::make_unique<dispatch_timer>(make_timer_api(), signals);
+  }
 
-static std::string read_line_from_file(const std::string& full_path, size_t line_number) {
-  std::ifstream file(full_path);
-  if (!file) {
-    LOG_WARN("Failed to open file {}", full_path);
-    return "";
+  const char* kernarg_env = std::getenv("NEXUS_KERNARG_SCAN");
+  if (kernarg_env && std::atoi(kernarg_env) != 0) {
+    const char* records_env = std::getenv("NEXUS_KERNARG_SCAN_RECORDS");
+    const std::size_t records = records_env ? std::atoi(records_env) : 1024;
+    LOG_INFO("Kernel argument scan enabled ({} records)", records);
+    kernarg_scanner_ = std::make_unique<kernarg_scanner>(allocations_, records);
   }
 
-  std::string line;
-  size_t current_line = 0;
+  const auto attach_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - attach_start)
+                             .count();
+  std::lock_guard g(startup_mutex_);
+  startup_phases_.push_back({"attach", static_cast<std::uint64_t>(attach_ns), false});
+  attached_ = true;
+  for (const auto& phase : startup_phases_) {
+    LOG_DETAIL("Startup phase {}: {} us", phase.name, phase.ns / 1000);
+  }
+  LOG_INFO("Attached in {} us{}", attach_ns / 1000, fast_attach_ ? " (fast attach)" : "");
+}
 
-  while (std::getline(file, line)) {
-    if (current_line == line_number) {
-      return line;
+void nexus::ensure_agents() {
+  std::call_once(agents_once_, [this] {
+    if (detail::log_enabled(detail::LogLevel::DETAIL)) {
+      // Names only feed the log
+      LOG_DETAIL("Discovering agents.");
+      discover_agents();
+      for (const auto& pair : agents_names_) {
+        LOG_DETAIL("Agent Handle: 0x{:x} , Name: {}", pair.first.handle, pair.second);
+      }
     }
-    ++current_line;
-  }
 
-  LOG_WARN("Line number {} not found in file {}", line_number, full_path);
-  return "";
+    timed_phase("agents", [this] { HsaAgent::get_all_agents(agents_); });
+    for (const auto& agent : agents_) {
+      if (!agent.is_gpu) {
+        continue;
+      }
+      for (const auto& pool : agent.memory_pools) {
+        device_pools_.insert(pool.pool.handle);
+      }
+      for (const auto& region : agent.memory_regions) {
+        device_pools_.insert(region.region.handle);
+      }
+    }
+    if (detail::log_enabled(detail::LogLevel::DETAIL)) {
+      for (const auto& agent : agents_) {
+        agent.print_info();
+      }
+    }
+    timed_phase("staging_pools", [this] { create_staging_pools(); });
+
+    auto gpu = std::find_if(agents_.begin(), agents_.end(), [](const HsaAgent& agent) {
+      return agent.is_gpu;
+    });
+    if (gpu == agents_.end()) {
+      LOG_ERROR("No GPU Agent Found");
+      std::terminate();
+    }
+    gpu_agent_ = gpu->agent;
+  });
 }
 
-nexus::nexus(HsaApiTable* table,
-             uint64_t runtime_version,
-             uint64_t failed_tool_count,
-             const char* const* failed_tool_names)
-    : api_table_{table} {
-  LOG_DETAIL("Saving current APIs.");
-  save_hsa_api();
-  LOG_DETAIL("Hooking new APIs.");
-  hook_api();
-  LOG_DETAIL("Discovering agents.");
-  discover_agents();
+kernelDB::kernelDB& nexus::ensure_kdb() {
+  std::call_once(kdb_once_, [this] {
+    ensure_agents();
+    timed_phase("kernel_db",
+                [this] { kdb_ = std::make_unique<kernelDB::kernelDB>(gpu_agent_); });
+  });
+  return *kdb_;
+}
 
-  for (const auto& pair : agents_names_) {
-    LOG_DETAIL("Agent Handle: 0x{:x} , Name: {}", pair.first.handle, pair.second);
+nlohmann::json nexus::startup_stats() {
+  std::lock_guard g(startup_mutex_);
+  nlohmann::json phases = nlohmann::json::array();
+  for (const auto& phase : startup_phases_) {
+    phases.push_back(
+        {{"name", phase.name}, {"ns", phase.ns}, {"deferred", phase.deferred}});
   }
+  return {{"fast_attach", fast_attach_}, {"phases", std::move(phases)}};
+}
+
+dispatch_timer_api nexus::make_timer_api() {
+  dispatch_timer_api api{};
+  api.signal_create = [](std::uint64_t* signal) {
+    hsa_signal_t s{};
+    const auto status =
+        hsa_core_call(get_instance(), hsa_signal_create, 1, 0, nullptr, &s);
+    *signal = s.handle;
+    return status == HSA_STATUS_SUCCESS;
+  };
+  api.signal_destroy = [](std::uint64_t signal) {
+    hsa_core_call(get_instance(), hsa_signal_destroy, hsa_signal_t{signal});
+  };
+  api.signal_reset = [](std::uint64_t signal) {
+    hsa_core_call(get_instance(), hsa_signal_store_screlease, hsa_signal_t{signal}, 1);
+  };
+  api.signal_forward = [](std::uint64_t signal) {
+    hsa_core_call(get_instance(), hsa_signal_subtract_screlease, hsa_signal_t{signal}, 1);
+  };
+  api.on_completion = [](std::uint64_t signal,
+                         dispatch_timer_api::completion_handler handler,
+                         void* arg) {
+    return hsa_ext_call(get_instance(),
+                        hsa_amd_signal_async_handler,
+                        hsa_signal_t{signal},
+                        HSA_SIGNAL_CONDITION_LT,
+                        1,
+                        handler,
+                        arg) == HSA_STATUS_SUCCESS;
+  };
+  api.dispatch_time = [](std::uint64_t agent,
+                         std::uint64_t signal,
+                         std::uint64_t* start,
+                         std::uint64_t* end) {
+    // Dispatch times are in the system timestamp domain
+    static const std::uint64_t frequency = [] {
+      std::uint64_t hz = 0;
+      hsa_core_call(
+          get_instance(), hsa_system_get_info, HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &hz);
+      return hz ? hz : 1000000000;
+    }();
+    hsa_amd_profiling_dispatch_time_t time{};
+    const auto status = hsa_ext_call(get_instance(),
+                                     hsa_amd_profiling_get_dispatch_time,
+                                     hsa_agent_t{agent},
+                                     hsa_signal_t{signal},
+                                     &time);
+    const auto to_ns = [](std::uint64_t ticks) {
+      return static_cast<std::uint64_t>(static_cast<unsigned __int128>(ticks) *
+                                        1000000000 / frequency);
+    };
+    *start = to_ns(time.start);
+    *end = to_ns(time.end);
+    return status == HSA_STATUS_SUCCESS;
+  };
+  return api;
+}
 
-  HsaAgent::get_all_agents(agents_);
+std::optional<hsa_amd_memory_pool_t> nexus::nearest_host_pool(hsa_agent_t gpu) {
+  std::optional<hsa_amd_memory_pool_t> nearest;
+  std::uint32_t nearest_distance = UINT32_MAX;
   for (const auto& agent : agents_) {
-    agent.print_info();
-  }
+    if (agent.is_gpu) {
+      continue;
+    }
+    for (const auto& candidate : agent.memory_pools) {
+      hsa_amd_segment_t segment;
+      std::uint32_t flags = 0;
+      bool alloc_allowed = false;
+      hsa_ext_call(this,
+                   hsa_amd_memory_pool_get_info,
+                   candidate.pool,
+                   HSA_AMD_MEMORY_POOL_INFO_SEGMENT,
+                   &segment);
+      hsa_ext_call(this,
+                   hsa_amd_memory_pool_get_info,
+                   candidate.pool,
+                   HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS,
+                   &flags);
+      hsa_ext_call(this,
+                   hsa_amd_memory_pool_get_info,
+                   candidate.pool,
+                   HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED,
+                   &alloc_allowed);
+      if (segment != HSA_AMD_SEGMENT_GLOBAL || !alloc_allowed ||
+          !(flags & HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED)) {
+        continue;
+      }
 
-  HsaAgent gpu_agent;
-  bool gpu_agent_exist = HsaAgent::find_first_gpu_agent(agents_, gpu_agent);
-  if (!gpu_agent_exist) {
-    LOG_ERROR("No GPU Agent Found");
-    std::terminate();
+      // Distance of the first link from the GPU to this pool's NUMA node
+      std::uint32_t hops = 0;
+      hsa_ext_call(this,
+                   hsa_amd_agent_memory_pool_get_info,
+                   gpu,
+                   candidate.pool,
+                   HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS,
+                   &hops);
+      std::uint32_t distance = UINT32_MAX - 1;
+      if (hops > 0) {
+        std::vector<hsa_amd_memory_pool_link_info_t> links(hops);
+        if (hsa_ext_call(this,
+                         hsa_amd_agent_memory_pool_get_info,
+                         gpu,
+                         candidate.pool,
+                         HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO,
+                         links.data()) == HSA_STATUS_SUCCESS) {
+          distance = links[0].numa_distance;
+        }
+      }
+      if (distance < nearest_distance) {
+        nearest = candidate.pool;
+        nearest_distance = distance;
+      }
+    }
   }
-  gpu_agent_ = gpu_agent;
-  kdb_ = std::make_unique<kernelDB::kernelDB>(gpu_agent.agent);
+  return nearest;
 }
 
-static void* memcpy_d2h(const void* device_ptr,
-                        size_t size,
-                        const std::vector<HsaAgent>& agents_) {
-  // Find a CPU agent with a fine-grained memory region
-  for (const auto& agent : agents_) {
-    if (!agent.is_gpu) {  // Find a CPU agent
-      for (const auto& region : agent.memory_regions) {
-        if (region.is_global) {  // Fine-grained memory for CPU
-          void* host_ptr = nullptr;
-          hsa_status_t status = hsa_memory_allocate(region.region, size, &host_ptr);
+void nexus::create_staging_pools() {
+  const char* retained_env = std::getenv("NEXUS_STAGING_POOL_MB");
+  const std::size_t retained_mb = retained_env ? std::atoi(retained_env) : 64;
 
-          LOG_DETAIL("Allocated CPU pointer {} ({} bytes).", host_ptr, size);
-          if (status != HSA_STATUS_SUCCESS || host_ptr == nullptr) {
-            LOG_DETAIL("Failed to allocate fine-grained host memory of size {}", size);
-            return nullptr;
-          }
+  staging_pool_api api{};
+  api.allocate = [](void* context, std::size_t size, void** ptr) {
+    // Straight to the runtime so that staging does not show up in the
+    // application's allocation stats
+    auto& target = *static_cast<staging_target*>(context);
+    auto instance = get_instance();
+    if (hsa_ext_call(instance,
+                     hsa_amd_memory_pool_allocate,
+                     target.host_pool,
+                     size,
+                     0,
+                     ptr) != HSA_STATUS_SUCCESS) {
+      return false;
+    }
+    if (hsa_ext_call(
+            instance, hsa_amd_agents_allow_access, 1, &target.gpu, nullptr, *ptr) !=
+        HSA_STATUS_SUCCESS) {
+      hsa_ext_call(instance, hsa_amd_memory_pool_free, *ptr);
+      return false;
+    }
+    return true;
+  };
+  api.free = [](void*, void* ptr) {
+    hsa_ext_call(get_instance(), hsa_amd_memory_pool_free, ptr);
+  };
 
-          // Copy memory from device to host
-          LOG_DETAIL("D2H copying to {} from ({} bytes).", host_ptr, device_ptr, size);
+  for (const auto& agent : agents_) {
+    if (!agent.is_gpu) {
+      continue;
+    }
+    const auto host_pool = nearest_host_pool(agent.agent);
+    if (!host_pool) {
+      LOG_WARN("No fine-grained host memory pool reachable from {}", agent.name);
+      continue;
+    }
+    auto target = std::make_unique<staging_target>();
+    target->gpu = agent.agent;
+    target->host_pool = *host_pool;
+    api.context = target.get();
+    target->staging = std::make_unique<staging_pool>(api, retained_mb << 20);
+    LOG_DETAIL("Staging for {} from host pool 0x{:x}", agent.name, host_pool->handle);
+    staging_targets_.emplace(agent.agent.handle, std::move(target));
+  }
+}
 
-          status = hsa_memory_copy(host_ptr, device_ptr, size);
-          if (status != HSA_STATUS_SUCCESS) {
-            LOG_DETAIL("Failed to copy device memory to host");
-            hsa_amd_memory_pool_free(host_ptr);
-            return nullptr;
-          }
+staging_buffer nexus::copy_to_host(hsa_agent_t gpu, const void* device_ptr, size_t size) {
+  ensure_agents();
+  auto it = staging_targets_.find(gpu.handle);
+  if (it == staging_targets_.end()) {
+    LOG_DETAIL("No staging pool for agent 0x{:x}", gpu.handle);
+    return {};
+  }
+  auto buffer = it->second->staging->acquire(size);
+  if (!buffer) {
+    LOG_DETAIL("Failed to allocate {} bytes of staging memory", size);
+    return {};
+  }
 
-          return host_ptr;
-        }
-      }
-    }
+  LOG_DETAIL("D2H copying to {} from {} ({} bytes).", buffer.data(), device_ptr, size);
+  if (hsa_core_call(this, hsa_memory_copy, buffer.data(), device_ptr, size) !=
+      HSA_STATUS_SUCCESS) {
+    LOG_DETAIL("Failed to copy device memory to host");
+    return {};
   }
+  return buffer;
+}
 
-  LOG_DETAIL("No suitable CPU agent with fine-grained memory found.");
-  return nullptr;
+nlohmann::json nexus::staging_stats() {
+  nlohmann::json pools = nlohmann::json::array();
+  for (const auto& [handle, target] : staging_targets_) {
+    const auto c = target->staging->get_counters();
+    if (c.acquires == 0) {
+      continue;
+    }
+    LOG_INFO("Staging for agent 0x{:x}: {} copies, {} reused, {} bytes peak",
+             handle,
+             c.acquires,
+             c.reuses,
+             c.peak_bytes);
+    pools.push_back({{"agent", handle},
+                     {"host_pool", target->host_pool.handle},
+                     {"acquires", c.acquires},
+                     {"reuses", c.reuses},
+                     {"allocations", c.allocations},
+                     {"frees", c.frees},
+                     {"failures", c.failures},
+                     {"peak_bytes", c.peak_bytes}});
+  }
+  return pools;
 }
 
 void nexus::discover_agents() {
@@ -235,41 +480,42 @@ void nexus::dump_all_code_objects(const std::filesystem::path& json_path) {
   LOG_DETAIL("Dumping all code objects");
 
   std::vector<std::string> kernels;
-  kdb_->getKernels(kernels);
-  LOG_DETAIL("Dumping {} kernels", kernels.size());
-  nlohmann::json file_array = nlohmann::json::array();
-  nlohmann::json hip_array = nlohmann::json::array();
-  nlohmann::json assembly_array = nlohmann::json::array();
-  nlohmann::json json;
-  for (const auto& kernel_name : kernels) {
+  ensure_kdb().getKernels(kernels);
+
+  // kernelDB is only read here, and kdb_mutex_ keeps ingestion out
+  const char* threads_env = std::getenv("NEXUS_DUMP_THREADS");
+  const std::size_t num_threads =
+      threads_env ? std::atoi(threads_env) : std::thread::hardware_concurrency();
+  LOG_DETAIL("Dumping {} kernels on {} threads", kernels.size(), num_threads);
+
+  const auto isa = [this](const std::string& kernel_name,
+                          std::vector<std::string_view>& instructions) {
     try {
-      if (kernel_name == ".text") {
-        continue;
-      }
       const auto& kernel = kdb_->getKernel(kernel_name);
-      const auto& basic_blocks = kernel.getBasicBlocks();
-      for (const auto& block : basic_blocks) {
-        const auto& instructions = block->getInstructions();
-        for (const auto& inst : instructions) {
-          auto instruction = inst.disassembly_;
-          instruction.erase(std::remove(instruction.begin(), instruction.end(), '\t'),
-                            instruction.end());
-          assembly_array.push_back(instruction);
+      for (const auto& block : kernel.getBasicBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+          instructions.emplace_back(inst.disassembly_);
         }
       }
-      json["kernels"][kernel_name]["assembly"] = std::move(assembly_array);
-      json["kernels"][kernel_name]["signature"] = kernel_name;
+      return true;
     } catch (const std::exception& e) {
       LOG_ERROR("Error dumping kernel {}", kernel_name);
       LOG_ERROR("{}", e.what());
+      return false;
     }
+  };
 
-    std::ofstream file(json_path);
-    if (file) {
-      file << json.dump(4);
-    } else {
-      LOG_DETAIL("Failed to write JSON to: {}", json_path.string());
-    }
+  // A store of its own: owners in the trace store must stay traced kernels
+  isa_store store;
+  const auto document =
+      render_kernel_dump(std::move(kernels), isa, store, num_threads, shared_isa_);
+  const auto isa_counts = store.get_stats();
+  LOG_DETAIL("Dump ISA: {} instructions, {} kernels in {} distinct bodies",
+             isa_counts.instructions,
+             isa_counts.kernels,
+             isa_counts.unique_blocks);
+  if (!write_file_atomically(json_path.string(), document)) {
+    LOG_DETAIL("Failed to write JSON to: {}", json_path.string());
   }
 }
 
@@ -280,6 +526,7 @@ hsa_status_t nexus::hsa_shut_down() {
   const char* full_trace_path = std::getenv("NEXUS_KERNELS_DUMP_FILE");
   if (full_trace_path) {
     const std::filesystem::path json_path(full_trace_path);
+    std::lock_guard g(instance->kdb_mutex_);
     instance->dump_all_code_objects(json_path);
   }
 
@@ -293,23 +540,22 @@ std::string demangle_name(const char* mangled_name) {
   return (status == 0) ? result.get() : mangled_name;
 }
 
-std::string nexus::get_kernel_name(const std::uint64_t kernel_object) {
-  auto handle_find_result = handles_symbols_.find(kernel_object);
-  if (handle_find_result == handles_symbols_.end()) {
-    return "Object not found.";
-  }
-  auto symbol_find_result = symbols_names_.find(handle_find_result->second);
-  if (handle_find_result == handles_symbols_.end()) {
-    return "Symbol not found.";
-  }
-  auto demangled_name = demangle_name(symbol_find_result->second.c_str());
-
-  size_t clone_suffix_pos = demangled_name.find(" [clone");
+// Demangled kernel name without the " [clone ...]" suffix of specialized clones
+static std::string kernel_display_name(const char* mangled_name) {
+  auto name = demangle_name(mangled_name);
+  const auto clone_suffix_pos = name.find(" [clone");
   if (clone_suffix_pos != std::string::npos) {
-    demangled_name = demangled_name.substr(0, clone_suffix_pos);
+    name.resize(clone_suffix_pos);
   }
+  return name;
+}
 
-  return demangled_name;
+std::string_view nexus::get_kernel_name(const std::uint64_t kernel_object) {
+  const auto* symbol = symbol_table_.find(kernel_object);
+  if (!symbol) {
+    return "Object not found.";
+  }
+  return symbol->name;
 }
 
 std::string nexus::packet_to_text(const hsa_ext_amd_aql_pm4_packet_t* packet) {
@@ -330,9 +576,8 @@ std::string nexus::packet_to_text(const hsa_ext_amd_aql_pm4_packet_t* packet) {
           reinterpret_cast<const hsa_kernel_dispatch_packet_t*>(packet);
       uint32_t scope = get_header_release_scope(disp);
       const auto kernel_name = get_kernel_name(disp->kernel_object);
-      static const char* kernel_to_trace = std::getenv("KERNEL_TO_TRACE");
 
-      if (kernel_to_trace != nullptr && kernel_name.starts_with(kernel_to_trace)) {
+      if (!kernel_filter_->traces_all() && kernel_filter_->matches(kernel_name)) {
         buff << ("\nTracing the kernel\n");
       }
 
@@ -393,36 +638,16 @@ std::string nexus::packet_to_text(const hsa_ext_amd_aql_pm4_packet_t* packet) {
   return buff.str();
 }
 
-std::optional<std::string> nexus::is_traceable_packet(
-    const hsa_ext_amd_aql_pm4_packet_t* packet) {
-  uint32_t type = get_header_type(packet);
-  switch (type) {
-    case HSA_PACKET_TYPE_KERNEL_DISPATCH: {
-      const hsa_kernel_dispatch_packet_t* disp =
-          reinterpret_cast<const hsa_kernel_dispatch_packet_t*>(packet);
-      uint32_t scope = get_header_release_scope(disp);
-      const auto kernel_name = get_kernel_name(disp->kernel_object);
-      static const char* kernel_to_trace = std::getenv("KERNEL_TO_TRACE");
-
-      if (kernel_to_trace == nullptr) {
-        return kernel_name;
-      } else {
-        std::string_view kernels(kernel_to_trace);
-        size_t start = 0;
-        while (start < kernels.size()) {
-          size_t end = kernels.find(';', start);
-          if (end == std::string_view::npos) {
-            end = kernels.size();
-          }
-          auto token = kernels.substr(start, end - start);
-          if (kernel_name.contains(token)) {
-            LOG_INFO("Found the target kernel {}", kernel_name);
-            return kernel_name;
-          }
-          start = end + 1;
-        }
-      }
-    }
+// Only called on a kernel_cache_ miss; the decision is then cached per
+// kernel_object together with the name
+std::optional<std::string> nexus::is_traceable_kernel(std::uint64_t kernel_object) {
+  const auto kernel_name = get_kernel_name(kernel_object);
+  if (kernel_filter_->traces_all()) {
+    return std::string(kernel_name);
+  }
+  if (kernel_filter_->matches(kernel_name)) {
+    LOG_INFO("Found the target kernel {}", kernel_name);
+    return std::string(kernel_name);
   }
   return {};
 }
@@ -431,15 +656,229 @@ nexus* nexus::get_instance(HsaApiTable* table,
                            uint64_t runtime_version,
                            uint64_t failed_tool_count,
                            const char* const* failed_tool_names) {
+  // Every intercepted call comes through here; only the first one locks
+  if (auto* instance = singleton_.load(std::memory_order_acquire); instance || !table) {
+    return instance;
+  }
   const std::lock_guard<std::mutex> lock(mutex_);
-  if (!singleton_) {
-    if (table != NULL) {
-      singleton_ =
-          new nexus(table, runtime_version, failed_tool_count, failed_tool_names);
-    } else {
+  if (!singleton_.load(std::memory_order_relaxed)) {
+    singleton_.store(
+        new nexus(table, runtime_version, failed_tool_count, failed_tool_names),
+        std::memory_order_release);
+  }
+  return singleton_.load(std::memory_order_relaxed);
+}
+
+void nexus::finalize() {
+  auto instance = get_instance();
+  if (!instance || instance->finalized_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  nlohmann::json stats;
+  if (instance->pipeline_) {
+    instance->pipeline_->stop();
+    const auto counters = instance->pipeline_->get_counters();
+    LOG_INFO("Dispatch records: {} submitted, {} processed, {} dropped, {} sampled out",
+             counters.submitted,
+             counters.processed,
+             counters.dropped,
+             counters.sampled_out);
+    stats["pipeline"] = {{"submitted", counters.submitted},
+                         {"processed", counters.processed},
+                         {"dropped", counters.dropped},
+                         {"sampled_out", counters.sampled_out}};
+  }
+  if (instance->timer_) {
+    instance->timer_->stop();
+    stats.update(instance->timing_stats());
+  }
+  if (instance->trace_writer_) {
+    instance->trace_writer_->finish();
+  }
+  stats["memory"] = instance->memory_stats();
+  stats["staging"] = instance->staging_stats();
+  stats["isa"] = instance->isa_stats();
+  stats["startup"] = instance->startup_stats();
+  if (instance->cache_) {
+    stats["cache"] = instance->cache_stats();
+  }
+  for (auto& [handle, target] : instance->staging_targets_) {
+    target->staging->release();
+  }
+  if (instance->kernarg_scanner_) {
+    instance->kernarg_scanner_->stop();
+    stats.update(instance->kernarg_stats());
+  }
+
+  const char* stats_path = std::getenv("NEXUS_STATS_FILE");
+  if (stats_path && !stats.is_null()) {
+    write_stats_file(stats_path, stats);
+  }
+  // Later messages are written synchronously
+  detail::log_sink::shutdown();
+}
+
+nlohmann::json nexus::timing_stats() {
+  std::unordered_map<std::uint64_t, std::string> names;
+  kernel_cache_.for_each(
+      [&names](std::uint64_t kernel_object, const kernel_entry& entry) {
+        names.emplace(kernel_object, entry.name);
+      });
+
+  // The same kernel loaded on several agents has one kernel_object per agent
+  std::map<std::string, kernel_timing> by_name;
+  for (const auto& [kernel_object, timing] : timer_->get_timings()) {
+    auto it = names.find(kernel_object);
+    const auto name = it != names.end() && !it->second.empty()
+                          ? it->second
+                          : fmt::format("0x{:x}", kernel_object);
+    auto& t = by_name[name];
+    t.dispatches += timing.dispatches;
+    t.total_ns += timing.total_ns;
+    t.min_ns = std::min(t.min_ns, timing.min_ns);
+    t.max_ns = std::max(t.max_ns, timing.max_ns);
+    t.first_start = std::min(t.first_start, timing.first_start);
+    t.last_end = std::max(t.last_end, timing.last_end);
+  }
+
+  nlohmann::json kernels = nlohmann::json::object();
+  std::uint64_t timed = 0;
+  for (const auto& [name, t] : by_name) {
+    timed += t.dispatches;
+    LOG_DETAIL("{}: {} dispatches, {} ns total, {} ns mean",
+               name,
+               t.dispatches,
+               t.total_ns,
+               t.total_ns / t.dispatches);
+    kernels[name] = {{"dispatches", t.dispatches},
+                     {"total_ns", t.total_ns},
+                     {"mean_ns", t.total_ns / t.dispatches},
+                     {"min_ns", t.min_ns},
+                     {"max_ns", t.max_ns},
+                     {"first_start_ns", t.first_start},
+                     {"last_end_ns", t.last_end}};
+  }
+
+  const auto counters = timer_->get_counters();
+  LOG_INFO("Dispatch timing: {} timed, {} not timed (no free signal), {} failed",
+           timed,
+           counters.exhausted,
+           counters.failed);
+  return {{"timing",
+           {{"attached", counters.attached},
+            {"completed", counters.completed},
+            {"exhausted", counters.exhausted},
+            {"failed", counters.failed}}},
+          {"kernels", std::move(kernels)}};
+}
+
+nlohmann::json nexus::kernarg_stats() {
+  // Only traced kernels are reported; first dispatches are scanned before the
+  // filter has run
+  std::unordered_map<std::uint64_t, std::string> names;
+  kernel_cache_.for_each(
+      [&names](std::uint64_t kernel_object, const kernel_entry& entry) {
+        if (entry.traced) {
+          names.emplace(kernel_object, entry.name);
+        }
+      });
+
+  std::map<std::string, kernel_footprint> by_name;
+  for (auto& [kernel_object, footprint] : kernarg_scanner_->get_footprints()) {
+    auto it = names.find(kernel_object);
+    if (it == names.end()) {
+      continue;
+    }
+    auto& f = by_name[it->second];
+    f.dispatches += footprint.dispatches;
+    f.total_bytes += footprint.total_bytes;
+    f.max_bytes = std::max(f.max_bytes, footprint.max_bytes);
+    f.buffers.merge(footprint.buffers);
+  }
+
+  nlohmann::json kernels = nlohmann::json::object();
+  for (const auto& [name, f] : by_name) {
+    std::uint64_t unique_bytes = 0;
+    for (const auto& [base, size] : f.buffers) {
+      unique_bytes += size;
+    }
+    LOG_DETAIL("{}: {} buffers, {} bytes, {} bytes at most per dispatch",
+               name,
+               f.buffers.size(),
+               unique_bytes,
+               f.max_bytes);
+    kernels[name] = {{"dispatches", f.dispatches},
+                     {"buffers", f.buffers.size()},
+                     {"unique_bytes", unique_bytes},
+                     {"mean_bytes", f.dispatches ? f.total_bytes / f.dispatches : 0},
+                     {"max_bytes", f.max_bytes}};
+  }
+
+  const auto counters = kernarg_scanner_->get_counters();
+  LOG_INFO(
+      "Kernel argument scan: {} scanned, {} dropped, {} truncated, {} in device memory",
+      counters.scanned,
+      counters.dropped,
+      counters.truncated,
+      counters.device_resident);
+  return {{"kernarg_scan",
+           {{"submitted", counters.submitted},
+            {"scanned", counters.scanned},
+            {"dropped", counters.dropped},
+            {"truncated", counters.truncated},
+            {"device_resident", counters.device_resident}}},
+          {"footprints", std::move(kernels)}};
+}
+
+nlohmann::json nexus::memory_stats() {
+  nlohmann::json pools = nlohmann::json::array();
+  for (const auto& usage : allocations_.usage()) {
+    const bool region = usage.source == allocation_source::REGION;
+    LOG_INFO("Memory {} 0x{:x}: {} bytes live in {} allocations, {} bytes peak",
+             region ? "region" : "pool",
+             usage.pool,
+             usage.live_bytes,
+             usage.live_allocations,
+             usage.peak_bytes);
+    // Keyed by the smallest size in each power-of-two bucket
+    nlohmann::json histogram = nlohmann::json::object();
+    for (std::size_t i = 0; i < usage.size_histogram.size(); i++) {
+      if (usage.size_histogram[i]) {
+        const std::uint64_t min_size = i ? std::uint64_t{1} << (i - 1) : 0;
+        histogram[std::to_string(min_size)] = usage.size_histogram[i];
+      }
     }
+    pools.push_back({{"kind", region ? "region" : "memory_pool"},
+                     {"handle", usage.pool},
+                     {"live_bytes", usage.live_bytes},
+                     {"peak_bytes", usage.peak_bytes},
+                     {"live_allocations", usage.live_allocations},
+                     {"allocations", usage.allocations},
+                     {"frees", usage.frees},
+                     {"size_histogram", std::move(histogram)}});
+  }
+  return pools;
+}
+
+void nexus::write_stats_file(const std::filesystem::path& path,
+                             const nlohmann::json& stats) {
+  auto tmp_path = path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream out(tmp_path);
+    if (!out) {
+      LOG_ERROR("Unable to open stats file {}", tmp_path.string());
+      return;
+    }
+    out << stats.dump(4) << "\n";
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    LOG_ERROR("Unable to write stats file {}: {}", path.string(), ec.message());
+    return;
   }
-  return singleton_;
+  LOG_INFO("Statistics written to {}", path.string());
 }
 
 nexus::~nexus() {
@@ -459,75 +898,36 @@ hsa_status_t nexus::hsa_code_object_reader_create_from_file(
   if (result != HSA_STATUS_SUCCESS) {
     LOG_ERROR("Failed to create a code object reader from file {}", file);
   }
-  return result;
-}
-
-static std::optional<std::string> find_mmap_file_from_ptr(const void* ptr) {
-  std::ifstream maps("/proc/self/maps");
-  std::string line;
 
-  const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
-
-  while (std::getline(maps, line)) {
-    std::istringstream iss(line);
-    std::string addr_range;
-    iss >> addr_range;
-
-    const size_t dash_pos = addr_range.find('-');
-    if (dash_pos == std::string::npos)
-      continue;
-
-    const uintptr_t start = std::stoull(addr_range.substr(0, dash_pos), nullptr, 16);
-    const uintptr_t end = std::stoull(addr_range.substr(dash_pos + 1), nullptr, 16);
-
-    if (address >= start && address < end) {
-      std::string unused, path;
-      for (int i = 0; i < 4 && iss; ++i)
-        iss >> unused;
-
-      std::getline(iss, path);
-      path.erase(0, path.find_first_not_of(" \t"));
-
-      if (path == "[heap]") {
-        return {};
-      }
-
-      // if (path.empty()) {
-      //   return {};
-      // }
-
-      // return path;
-      return path.empty() ? "[anonymous mapping]" : path;
+  struct stat st;
+  if (result == HSA_STATUS_SUCCESS && instance->kernarg_scanner_ &&
+      fstat(file, &st) == 0 && st.st_size > 0) {
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data != MAP_FAILED) {
+      instance->add_kernarg_sizes(*code_object_reader, data, st.st_size);
+      munmap(data, st.st_size);
     }
   }
-
-  return {};
-}
-
-std::string hash_memory(const char* data, size_t size) {
-  std::hash<std::string> hash_fn;
-  size_t bytes_to_hash = std::min(static_cast<size_t>(512), size);
-  std::string buffer(data, bytes_to_hash);
-  size_t hash_value = hash_fn(buffer);
-
-  // Convert the hash value to a hex string
-  std::stringstream ss;
-  ss << std::hex << std::setw(16) << std::setfill('0') << hash_value;
-  return ss.str();
+  return result;
 }
 
 hsa_status_t nexus::hsa_code_object_reader_create_from_memory(
     const void* code_object,
     size_t size,
     hsa_code_object_reader_t* code_object_reader) {
-  const auto filename = find_mmap_file_from_ptr(code_object);
+  auto instance = get_instance();
+  // Pseudo-paths ("[anonymous mapping]", large malloc'ed buffers) and deleted
+  // files cannot be opened by kernelDB; those objects are staged instead
+  auto filename = instance->mappings_.find(reinterpret_cast<std::uintptr_t>(code_object));
+  if (filename && !file_identity(*filename)) {
+    filename.reset();
+  }
 
   LOG_DETAIL("Creating a code object reader from memory {} ({} bytes) (filename: {})",
              code_object,
              size,
              filename.value_or("unknown"));
 
-  auto instance = get_instance();
   auto result = hsa_core_call(instance,
                               hsa_code_object_reader_create_from_memory,
                               code_object,
@@ -539,30 +939,183 @@ hsa_status_t nexus::hsa_code_object_reader_create_from_memory(
               size);
   }
 
-  if (instance->kdb_) {
-    if (filename.has_value()) {
-      instance->kdb_->addFile(filename.value(), instance->gpu_agent_.agent, "");
-    } else {
-      LOG_DETAIL(
-          "Failed to find the file name for the code object. Dumping to temp file.");
+  if (result == HSA_STATUS_SUCCESS) {
+    static const auto mode = parse_staging(std::getenv("NEXUS_CODE_OBJECT_STAGING"));
+    const auto hash = hash_code_object(code_object, size);
 
-      std::string hash_str =
-          hash_memory(reinterpret_cast<const char*>(code_object), size);
+    auto location = instance->code_objects_.intern(
+        hash, filename, [&]() -> std::shared_ptr<code_object_location> {
+          if (filename.has_value()) {
+            return std::make_shared<code_object_location>(filename.value());
+          }
+          LOG_DETAIL("Failed to find the file name for the code object. Staging it.");
+          auto staged = staged_code_object::stage(code_object, size, hash, mode);
+          if (!staged) {
+            return nullptr;
+          }
+          return std::make_shared<code_object_location>(std::move(*staged));
+        });
 
-      const auto tmp = std::filesystem::temp_directory_path() /
-                       ("nexus_code_object_" + hash_str + ".hsaco");
+    if (instance->kernarg_scanner_) {
+      instance->add_kernarg_sizes(*code_object_reader, code_object, size);
+    }
 
-      std::ofstream temp_file_stream(tmp, std::ios::binary);
-      temp_file_stream.write(reinterpret_cast<const char*>(code_object), size);
-      temp_file_stream.close();
-      LOG_DETAIL("Adding the code object {}", tmp.string());
-      instance->kdb_->addFile(tmp, instance->gpu_agent_.agent, "");
+    if (location) {
+      {
+        std::lock_guard g(instance->executables_mutex_);
+        instance->readers_code_objects_[code_object_reader->handle] = location;
+        instance->readers_hashes_[code_object_reader->handle] = hash;
+      }
+      if (instance->eager_ingest_) {
+        std::lock_guard g(instance->kdb_mutex_);
+        instance->ingest_locked(*location);
+      }
     }
   }
 
   return result;
 }
 
+hsa_status_t nexus::hsa_code_object_reader_destroy(
+    hsa_code_object_reader_t code_object_reader) {
+  auto instance = get_instance();
+  {
+    // Executables loaded from the reader keep their own reference
+    std::lock_guard g(instance->executables_mutex_);
+    instance->readers_code_objects_.erase(code_object_reader.handle);
+    instance->readers_hashes_.erase(code_object_reader.handle);
+    instance->readers_kernarg_sizes_.erase(code_object_reader.handle);
+  }
+  return hsa_core_call(instance, hsa_code_object_reader_destroy, code_object_reader);
+}
+
+hsa_status_t nexus::hsa_executable_load_agent_code_object(
+    hsa_executable_t executable,
+    hsa_agent_t agent,
+    hsa_code_object_reader_t code_object_reader,
+    const char* options,
+    hsa_loaded_code_object_t* loaded_code_object) {
+  auto instance = get_instance();
+  auto result = hsa_core_call(instance,
+                              hsa_executable_load_agent_code_object,
+                              executable,
+                              agent,
+                              code_object_reader,
+                              options,
+                              loaded_code_object);
+
+  if (result == HSA_STATUS_SUCCESS) {
+    std::lock_guard g(instance->executables_mutex_);
+    auto it = instance->readers_code_objects_.find(code_object_reader.handle);
+    if (it != instance->readers_code_objects_.end()) {
+      instance->executables_code_objects_[executable.handle].push_back(it->second);
+    }
+    auto hash = instance->readers_hashes_.find(code_object_reader.handle);
+    if (hash != instance->readers_hashes_.end()) {
+      instance->executables_hashes_[executable.handle].push_back(hash->second);
+    }
+    auto sizes = instance->readers_kernarg_sizes_.find(code_object_reader.handle);
+    if (sizes != instance->readers_kernarg_sizes_.end()) {
+      instance->executables_kernarg_sizes_[executable.handle].emplace_back(agent.handle,
+                                                                           sizes->second);
+    }
+  }
+  return result;
+}
+
+hsa_status_t nexus::hsa_executable_destroy(hsa_executable_t executable) {
+  auto instance = get_instance();
+  // Kernel handles are reused by code loaded later, so they must not keep
+  // the names or cached decisions of this executable's kernels
+  for (const auto& [symbol, kernel_object] : instance->executable_kernels(executable)) {
+    instance->kernel_cache_.evict(kernel_object);
+    instance->symbol_table_.retire(symbol, kernel_object);
+  }
+  {
+    std::lock_guard g(instance->executables_mutex_);
+    std::erase_if(instance->kernels_executables_, [&](const auto& entry) {
+      return entry.second.handle == executable.handle;
+    });
+    instance->executables_kernarg_sizes_.erase(executable.handle);
+  }
+  return hsa_core_call(instance, hsa_executable_destroy, executable);
+}
+
+std::vector<std::pair<std::uint64_t, std::uint64_t>> nexus::executable_kernels(
+    hsa_executable_t executable) {
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> kernels;
+  auto callback = [](hsa_executable_t,
+                     hsa_executable_symbol_t symbol,
+                     void* data) -> hsa_status_t {
+    auto instance = get_instance();
+    hsa_symbol_kind_t kind;
+    std::uint64_t kernel_object = 0;
+    if (hsa_core_call(instance,
+                      hsa_executable_symbol_get_info,
+                      symbol,
+                      HSA_EXECUTABLE_SYMBOL_INFO_TYPE,
+                      &kind) == HSA_STATUS_SUCCESS &&
+        kind == HSA_SYMBOL_KIND_KERNEL &&
+        hsa_core_call(instance,
+                      hsa_executable_symbol_get_info,
+                      symbol,
+                      HSA_EXECUTABLE_SYMBOL_INFO_KERNEL_OBJECT,
+                      &kernel_object) == HSA_STATUS_SUCCESS) {
+      static_cast<std::vector<std::pair<std::uint64_t, std::uint64_t>>*>(data)
+          ->emplace_back(symbol.handle, kernel_object);
+    }
+    return HSA_STATUS_SUCCESS;
+  };
+  hsa_core_call(this, hsa_executable_iterate_symbols, executable, callback, &kernels);
+  return kernels;
+}
+
+void nexus::ingest_locked(code_object_location& location) {
+  if (location.ingested) {
+    return;
+  }
+  LOG_DETAIL("Adding the code object {}", location.path);
+  ensure_kdb().addFile(location.path, gpu_agent_, "");
+  location.ingested = true;
+  // kernelDB has its own copy now; the memfd and its bytes can go
+  location.staged.reset();
+}
+
+void nexus::ingest_for_kernel_locked(std::uint64_t kernel_object) {
+  // Collect the candidates first so that loader hooks are not blocked behind
+  // a disassembly
+  std::vector<std::shared_ptr<code_object_location>> pending;
+  {
+    std::lock_guard g(executables_mutex_);
+    // kernel_object -> mangled name -> executable -> code objects
+    if (const auto* symbol = symbol_table_.find(kernel_object)) {
+      auto executable = kernels_executables_.find(std::string(symbol->mangled));
+      if (executable != kernels_executables_.end()) {
+        auto locations = executables_code_objects_.find(executable->second.handle);
+        if (locations != executables_code_objects_.end()) {
+          pending = locations->second;
+        }
+      }
+    }
+
+    if (pending.empty()) {
+      LOG_DETAIL(
+          "Code object of kernel_object 0x{:x} unknown, ingesting all pending ones",
+          kernel_object);
+      for (const auto& [handle, locations] : executables_code_objects_) {
+        pending.insert(pending.end(), locations.begin(), locations.end());
+      }
+      for (const auto& [handle, location] : readers_code_objects_) {
+        pending.push_back(location);
+      }
+    }
+  }
+
+  for (const auto& location : pending) {
+    ingest_locked(*location);
+  }
+}
+
 hsa_status_t nexus::hsa_executable_get_symbol_by_name(hsa_executable_t executable,
                                                       const char* symbol_name,
                                                       const hsa_agent_t* agent,
@@ -579,13 +1132,23 @@ hsa_status_t nexus::hsa_executable_get_symbol_by_name(hsa_executable_t executabl
                               agent,
                               symbol);
 
-  {
-    std::lock_guard g(mutex_);
-    const std::string kernel_name = std::string(symbol_name);
-    instance->symbols_names_[*symbol] = kernel_name;
-    instance->kernels_executables_[kernel_name] = executable;
+  if (result != HSA_STATUS_SUCCESS) {
+    return result;
   }
 
+  std::uint32_t kernarg_size = 0;
+  {
+    std::lock_guard g(instance->executables_mutex_);
+    instance->kernels_executables_[std::string(symbol_name)] = executable;
+    kernarg_size = instance->find_kernarg_size(executable, agent, symbol_name);
+  }
+  // Runtimes look the same kernel up again on every launch
+  if (instance->symbol_table_.has_symbol(symbol->handle)) {
+    return result;
+  }
+  // Demangle once here rather than on every dispatch
+  instance->symbol_table_.add_symbol(
+      symbol->handle, symbol_name, kernel_display_name(symbol_name), kernarg_size);
   return result;
 }
 
@@ -601,8 +1164,8 @@ hsa_status_t nexus::hsa_executable_symbol_get_info(
       attribute == HSA_EXECUTABLE_SYMBOL_INFO_KERNEL_OBJECT) {
     LOG_DETAIL("Looking up the symbol 0x{:x}", executable_symbol.handle);
 
-    std::lock_guard g(mutex_);
-    instance->handles_symbols_[*static_cast<std::uint64_t*>(value)] = executable_symbol;
+    instance->symbol_table_.add_kernel_object(*static_cast<std::uint64_t*>(value),
+                                              executable_symbol.handle);
   }
   return result;
 }
@@ -630,6 +1193,8 @@ void nexus::hook_api() {
   api_table_->amd_ext_->hsa_amd_memory_pool_allocate_fn =
       nexus::hsa_amd_memory_pool_allocate;
   api_table_->core_->hsa_memory_allocate_fn = nexus::hsa_memory_allocate;
+  api_table_->amd_ext_->hsa_amd_memory_pool_free_fn = nexus::hsa_amd_memory_pool_free;
+  api_table_->core_->hsa_memory_free_fn = nexus::hsa_memory_free;
 
   api_table_->core_->hsa_executable_get_symbol_by_name_fn =
       nexus::hsa_executable_get_symbol_by_name;
@@ -640,18 +1205,29 @@ void nexus::hook_api() {
   api_table_->core_->hsa_code_object_reader_create_from_memory_fn =
       nexus::hsa_code_object_reader_create_from_memory;
 
+  api_table_->core_->hsa_code_object_reader_destroy_fn =
+      nexus::hsa_code_object_reader_destroy;
+
+  api_table_->core_->hsa_executable_load_agent_code_object_fn =
+      nexus::hsa_executable_load_agent_code_object;
+
   api_table_->core_->hsa_executable_symbol_get_info_fn =
       nexus::hsa_executable_symbol_get_info;
 
+  api_table_->core_->hsa_executable_destroy_fn = nexus::hsa_executable_destroy;
+
   // Intercepting the hsa_shut_down function causes a crash at the end
   // For now, we are not going to intercept it and we will dump the trace
   // every time we see a new kernel
   // api_table_->core_->hsa_shut_down_fn = nexus::hsa_shut_down;
 }
 
-hsa_status_t nexus::add_queue(hsa_queue_t* queue, hsa_agent_t agent) {
+hsa_status_t nexus::add_queue(hsa_queue_t* queue, hsa_agent_t agent, void** data) {
   std::lock_guard<std::mutex> lock(mm_mutex_);
   auto instance = get_instance();
+  auto& intercepted = intercepted_queues_[queue];
+  intercepted = std::make_unique<intercepted_queue>(intercepted_queue{queue, agent});
+  *data = intercepted.get();
   auto result =
       hsa_ext_call(instance, hsa_amd_profiling_set_profiler_enabled, queue, true);
   return result;
@@ -664,143 +1240,297 @@ void nexus::on_submit_packet(const void* in_packets,
                              hsa_amd_queue_intercept_packet_writer writer) {
   auto instance = get_instance();
   if (instance) {
-    hsa_queue_t* queue = reinterpret_cast<hsa_queue_t*>(data);
-    instance->write_packets(queue,
+    const auto* intercepted = static_cast<const intercepted_queue*>(data);
+    instance->write_packets(intercepted->queue,
+                            intercepted->agent,
                             static_cast<const hsa_ext_amd_aql_pm4_packet_t*>(in_packets),
                             count,
                             writer);
   }
 }
 
-nlohmann::json nexus::get_all_isa(const std::string& kernel_name) {
-  nlohmann::json assembly_array = nlohmann::json::array();
-
+const isa_block* nexus::get_all_isa(const std::string& kernel_name, line_table* lines) {
   std::vector<std::string> kernels;
-  kdb_->getKernels(kernels);
+  ensure_kdb().getKernels(kernels);
   // search if the kernel_name is in the list of kernels
   auto it = std::find(kernels.begin(), kernels.end(), kernel_name);
   if (it == kernels.end()) {
     LOG_ERROR("Kernel not found in the list of kernels: {}", kernel_name);
-    return assembly_array;
+    return nullptr;
   }
 
+  // One walk over the basic blocks yields the ISA and, per instruction, its
+  // source line; file names are resolved once per debug info file entry
+  constexpr std::int64_t unresolved = -1;
+  std::vector<std::int64_t> path_files;
+  std::vector<std::string_view> instructions;
   auto& kernel = kdb_->getKernel(kernel_name);
   const auto& basic_blocks = kernel.getBasicBlocks();
   for (const auto& bb : basic_blocks) {
     const auto& isa = bb->getInstructions();
     for (const auto& inst : isa) {
-      std::string instruction = inst.disassembly_;
-      instruction.erase(std::remove(instruction.begin(), instruction.end(), '\t'),
-                        instruction.end());
-      assembly_array.push_back(instruction);
-      LOG_DETAIL("{}", instruction);
+      instructions.emplace_back(inst.disassembly_);
+      if (!lines) {
+        continue;
+      }
+      std::uint32_t file = 0;
+      if (inst.line_) {
+        if (inst.path_id_ >= path_files.size()) {
+          path_files.resize(inst.path_id_ + 1, unresolved);
+        }
+        auto& id = path_files[inst.path_id_];
+        if (id == unresolved) {
+          id = lines->add_file(kdb_->getFileName(kernel_name, inst.path_id_));
+        }
+        file = static_cast<std::uint32_t>(id);
+      }
+      lines->add(file, inst.line_);
     }
   }
+  if (lines) {
+    lines->finish();
+  }
 
-  return assembly_array;
+  const auto& block = isa_store_.intern(kernel_name, instructions);
+  for (const auto instruction : block.instructions) {
+    LOG_DETAIL("{}", instruction);
+  }
+  return &block;
 }
-void nexus::dump_intercepted_packets(const std::filesystem::path& json_path) {
-  std::ofstream file(json_path);
-  if (file) {
-    file << json_.dump(4);
-    LOG_DETAIL("Dumped kernel data to: {}", json_path.string());
-  } else {
-    LOG_DETAIL("Failed to write JSON to: {}", json_path.string());
+
+nlohmann::json nexus::isa_stats() {
+  const auto s = isa_store_.get_stats();
+  return {{"arena_bytes", s.arena_bytes},
+          {"instructions", s.instructions},
+          {"unique_strings", s.unique_strings},
+          {"kernels", s.kernels},
+          {"unique_blocks", s.unique_blocks}};
+}
+
+void nexus::extract_kernel(std::uint64_t kernel_object, const std::string& kernel_name) {
+  std::lock_guard<std::mutex> lock(kdb_mutex_);
+
+  // Another kernel_object (e.g. the same code object loaded on a second agent)
+  // may already have produced this kernel's record
+  if (extracted_kernels_.contains(kernel_name)) {
+    LOG_DETAIL("Kernel {} already extracted", kernel_name);
+    return;
+  }
+
+  std::optional<code_object_hash> cache_key;
+  if (cache_) {
+    cache_key = cache_key_for(kernel_object, kernel_name);
+  }
+  if (cache_key) {
+    if (auto cached = cache_->load(*cache_key)) {
+      LOG_DETAIL("Kernel {} found in the extraction cache", kernel_name);
+      auto& record = cached->record;
+      // The ISA moves out of the mapping into isa_store_ before it is unmapped
+      write_kernel_locked(record, &isa_store_.intern(kernel_name, record.assembly));
+      return;
+    }
+  }
+
+  // Code objects are only disassembled once one of their kernels is traced
+  ingest_for_kernel_locked(kernel_object);
+
+  kernel_record record;
+  record.name = kernel_name;
+  record.signature = kernel_name;
+
+  line_table table;
+  const auto* block = get_all_isa(kernel_name, &table);
+  if (block) {
+    record.assembly = block->instructions;
+  }
+  record.source_index = table.source_index();
+
+  // Keeps each file's mapping alive (and validated once) for this kernel
+  std::vector<std::shared_ptr<const source_file>> open_files(table.files().size());
+  std::vector<std::optional<std::string>> resolved_paths(table.files().size());
+  std::vector<bool> searched(table.files().size(), false);
+  std::vector<std::string> sources;
+
+  for (const auto& [file_id, line] : table.lines()) {
+    const auto& filename = table.files()[file_id];
+    if (!searched[file_id]) {
+      searched[file_id] = true;
+      resolved_paths[file_id] = search_index_->find(filename);
+      if (resolved_paths[file_id]) {
+        open_files[file_id] = source_cache_->open(*resolved_paths[file_id]);
+        if (open_files[file_id]) {
+          sources.push_back(*resolved_paths[file_id]);
+        }
+      }
+    }
+
+    record.lines.push_back(line);
+    record.files.push_back(filename);
+    if (const auto& file = open_files[file_id]) {
+      const auto& path = *resolved_paths[file_id];
+      record.hip.push_back(read_line_from_file(*file, path, line - 1));
+      LOG_INFO("{}:{}", filename, line - 1);
+    } else {
+      record.hip.push_back("");  // Could not find the file
+      LOG_WARN("Could not resolve file path for {} to read line {}", filename, line);
+    }
+  }
+  if (table.lines().empty()) {
+    LOG_WARN("No lines found for kernel: {}, dumping instructions only", kernel_name);
+  }
+
+  if (cache_key && block) {
+    cache_->store(*cache_key, record, sources);
+  }
+  write_kernel_locked(record, block);
+}
+
+void nexus::write_kernel_locked(kernel_record& record, const isa_block* block) {
+  if (block) {
+    record.assembly = block->instructions;
+    // Binary traces always carry the ISA; their string table dedups it
+    if (shared_isa_ && !block->instructions.empty() && block->owner != record.name) {
+      record.assembly_ref = block->owner;
+    }
+  }
+
+  trace_writer_->write_kernel(record);
+  extracted_kernels_.insert(record.name);
+
+  LOG_DETAIL("Processed kernel: {}", record.name);
+}
+
+std::optional<code_object_hash> nexus::cache_key_for(std::uint64_t kernel_object,
+                                                     const std::string& kernel_name) {
+  std::lock_guard g(executables_mutex_);
+  const auto* symbol = symbol_table_.find(kernel_object);
+  if (!symbol) {
+    return std::nullopt;
+  }
+  auto executable = kernels_executables_.find(std::string(symbol->mangled));
+  if (executable == kernels_executables_.end()) {
+    return std::nullopt;
+  }
+  auto hashes = executables_hashes_.find(executable->second.handle);
+  if (hashes == executables_hashes_.end() || hashes->second.empty()) {
+    return std::nullopt;
+  }
+  return extraction_cache::key(hashes->second, kernel_name, cache_salt_);
+}
+
+nlohmann::json nexus::cache_stats() {
+  if (!cache_) {
+    return {};
+  }
+  const auto c = cache_->get_counters();
+  LOG_INFO("Extraction cache: {} hits, {} misses ({} stale), {} stores, {} evictions",
+           c.hits,
+           c.misses,
+           c.stale,
+           c.stores,
+           c.evictions);
+  return {{"hits", c.hits},
+          {"misses", c.misses},
+          {"stale", c.stale},
+          {"stores", c.stores},
+          {"evictions", c.evictions},
+          {"errors", c.errors}};
+}
+
+void nexus::process_dispatch(const dispatch_record& record) {
+  const auto kernel_object = record.kernel_object;
+
+  // Several records for the same kernel can be queued before the first one
+  // is processed
+  if (kernel_cache_.hit(kernel_object)) {
+    return;
+  }
+
+  const bool registered = symbol_table_.find(kernel_object) != nullptr;
+
+  auto kernel_string = is_traceable_kernel(kernel_object);
+  if (kernel_string.has_value()) {
+    if (!trace_writer_) {
+      LOG_DETAIL("NEXUS_OUTPUT_FILE environment variable not set, skipping kernel trace");
+    } else {
+      LOG_DETAIL("Dumping the kernels at: {}", trace_writer_->output_path().string());
+    }
+    if (trace_writer_) {
+      extract_kernel(kernel_object, kernel_string.value());
+    }
+  }
+
+  // Unregistered kernel_objects resolve to a placeholder name; keep probing
+  // until the symbol shows up instead of caching the placeholder
+  if (registered) {
+    kernel_cache_.insert(
+        kernel_object, kernel_string.value_or(""), kernel_string.has_value());
   }
 }
 
+void nexus::write_timed_packets(hsa_agent_t agent,
+                                const hsa_ext_amd_aql_pm4_packet_t* packet,
+                                uint64_t count,
+                                const std::uint32_t* dispatches,
+                                std::size_t num_dispatches,
+                                hsa_amd_queue_intercept_packet_writer writer) {
+  // Packets are copied so that dispatches can complete a pooled signal;
+  // the application's own signal is forwarded when that signal fires
+  thread_local std::vector<hsa_ext_amd_aql_pm4_packet_t> packets;
+  packets.assign(packet, packet + count);
+  for (std::size_t i = 0; i < num_dispatches; i++) {
+    auto* disp = reinterpret_cast<hsa_kernel_dispatch_packet_t*>(&packets[dispatches[i]]);
+    const auto signal = timer_->attach(
+        disp->kernel_object, agent.handle, disp->completion_signal.handle);
+    if (signal) {
+      disp->completion_signal.handle = signal.value();
+    }
+  }
+  writer(packets.data(), count);
+}
+
 void nexus::write_packets(hsa_queue_t* queue,
+                          hsa_agent_t agent,
                           const hsa_ext_amd_aql_pm4_packet_t* packet,
                           uint64_t count,
                           hsa_amd_queue_intercept_packet_writer writer) {
   try {
-    LOG_DETAIL("Executing packet: {}", packet_to_text(packet));
-    auto instance = get_instance();
-
-    hsa_signal_t new_signal;
-    auto status = hsa_core_call(instance, hsa_signal_create, 1, 0, nullptr, &new_signal);
-
-    if (status != HSA_STATUS_SUCCESS) {
-      LOG_ERROR("Failed to create signal");
+    // One pass over the headers; barriers and vendor packets go straight through
+    thread_local std::vector<std::uint32_t> dispatches;
+    dispatches.resize(count);
+    const auto num_dispatches = find_dispatches(packet, count, dispatches.data());
+    if (num_dispatches == 0) {
+      writer(packet, count);
       return;
     }
 
-    writer(packet, count);
+    if (timer_) {
+      write_timed_packets(
+          agent, packet, count, dispatches.data(), num_dispatches, writer);
+    } else {
+      writer(packet, count);
+    }
 
-    auto kernel_string = is_traceable_packet(packet);
-    if (kernel_string.has_value()) {
-      const char* env_trace_path = std::getenv("NEXUS_OUTPUT_FILE");
+    for (std::size_t i = 0; i < num_dispatches; i++) {
+      const auto* disp =
+          reinterpret_cast<const hsa_kernel_dispatch_packet_t*>(&packet[dispatches[i]]);
+      LOG_DETAIL("Executing packet: {}", packet_to_text(&packet[dispatches[i]]));
 
-      if (!env_trace_path) {
-        LOG_DETAIL(
-            "NEXUS_OUTPUT_FILE environment variable not set, skipping kernel trace");
-      } else {
-        LOG_DETAIL("Dumping the kernels at: {}", env_trace_path);
+      // Kernels that were already filtered and extracted only bump their counter
+      const auto* entry = kernel_cache_.hit(disp->kernel_object);
+      if (kernarg_scanner_ && (!entry || entry->traced)) {
+        scan_kernargs(disp);
+      }
+      if (entry) {
+        continue;
       }
-      if (env_trace_path && kdb_) {
-        std::vector<uint32_t> lines;
-        kdb_->getKernelLines(kernel_string.value(), lines);
-        std::size_t cur_offset{0};
-
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        nlohmann::json line_array = nlohmann::json::array();
-        nlohmann::json file_array = nlohmann::json::array();
-        nlohmann::json hip_array = nlohmann::json::array();
-
-        std::set<std::pair<std::string, uint32_t>> seen_lines;
-
-        const std::string& kernel_name = kernel_string.value();
-
-        if (!lines.empty()) {
-          for (std::size_t line_idx = 0; line_idx < lines.size(); line_idx++) {
-            const auto& line = lines[line_idx];
-            const auto& inst = kdb_->getInstructionsForLine(kernel_name, line);
-
-            for (const auto& instruction_obj : inst) {
-              const auto& filename =
-                  kdb_->getFileName(kernel_name, instruction_obj.path_id_);
-              std::pair<std::string, uint32_t> line_key = {filename, line};
-
-              if (seen_lines.count(line_key)) {
-                continue;
-              }
-              seen_lines.insert(line_key);
-
-              line_array.push_back(line);
-              auto resolved_path = find_file_path(filename);
-              if (resolved_path) {
-                std::string source_line = read_line_from_file(*resolved_path, line - 1);
-                file_array.push_back(filename);
-                hip_array.push_back(source_line);
-                LOG_INFO("{}:{}", filename, line - 1);
-              } else {
-                file_array.push_back(filename);
-                hip_array.push_back("");  // Could not find the file
-                LOG_WARN(
-                    "Could not resolve file path for {} to read line {}", filename, line);
-              }
-              cur_offset++;
-            }
-          }
-        } else {
-          LOG_WARN("No lines found for kernel: {}, dumping instructions only",
-                   kernel_name);
-        }
-
-        nlohmann::json assembly_array = get_all_isa(kernel_name);
-
-        json_["kernels"][kernel_name]["lines"] = std::move(line_array);
-        json_["kernels"][kernel_name]["files"] = std::move(file_array);
-        json_["kernels"][kernel_name]["hip"] = std::move(hip_array);
-        json_["kernels"][kernel_name]["assembly"] = std::move(assembly_array);
-        json_["kernels"][kernel_name]["signature"] = kernel_name;
-
-        std::filesystem::path json_path = env_trace_path;
 
-        dump_intercepted_packets(json_path);
+      const dispatch_record record{disp->kernel_object};
 
-        LOG_DETAIL("Processed kernel: {}", kernel_name);
+      if (pipeline_) {
+        pipeline_->submit(record);
+      } else {
+        process_dispatch(record);
       }
     }
 
@@ -809,6 +1539,59 @@ void nexus::write_packets(hsa_queue_t* queue,
   }
 }
 
+void nexus::add_kernarg_sizes(hsa_code_object_reader_t code_object_reader,
+                              const void* code_object,
+                              std::size_t size) {
+  auto sizes = explicit_kernarg_sizes(code_object, size);
+  if (sizes.empty()) {
+    return;
+  }
+  std::lock_guard g(executables_mutex_);
+  readers_kernarg_sizes_[code_object_reader.handle] =
+      std::make_shared<const kernarg_sizes>(std::move(sizes));
+}
+
+std::uint32_t nexus::find_kernarg_size(hsa_executable_t executable,
+                                       const hsa_agent_t* agent,
+                                       const char* symbol_name) {
+  // Only the explicit arguments are scanned: the hidden ones point at
+  // runtime buffers (hostcall, heap, queue) that the kernel never names
+  auto loaded = executables_kernarg_sizes_.find(executable.handle);
+  if (loaded == executables_kernarg_sizes_.end()) {
+    return 0;
+  }
+  for (const auto& [loaded_agent, sizes] : loaded->second) {
+    if (agent && agent->handle != loaded_agent) {
+      continue;
+    }
+    auto it = sizes->find(symbol_name);
+    if (it != sizes->end()) {
+      return it->second;
+    }
+  }
+  return 0;
+}
+
+void nexus::scan_kernargs(const hsa_kernel_dispatch_packet_t* packet) {
+  // The explicit argument size comes from the code object metadata; kernels
+  // without it are not scanned rather than risking a read past the segment
+  const auto* symbol = symbol_table_.find(packet->kernel_object);
+  if (!symbol || !symbol->kernarg_size || !packet->kernarg_address) {
+    return;
+  }
+  // Device kernargs (HIP_FORCE_DEV_KERNARG, the default on MI300) would cost
+  // uncached reads over PCIe on every dispatch
+  ensure_agents();
+  const auto segment =
+      allocations_.find(reinterpret_cast<std::uint64_t>(packet->kernarg_address));
+  if (segment && device_pools_.contains(segment->pool)) {
+    kernarg_scanner_->skip_device_resident();
+    return;
+  }
+  kernarg_scanner_->submit(
+      packet->kernel_object, packet->kernarg_address, symbol->kernarg_size);
+}
+
 hsa_status_t nexus::hsa_amd_memory_pool_allocate(hsa_amd_memory_pool_t pool,
                                                  size_t size,
                                                  uint32_t flags,
@@ -817,8 +1600,10 @@ hsa_status_t nexus::hsa_amd_memory_pool_allocate(hsa_amd_memory_pool_t pool,
   const auto result =
       hsa_ext_call(instance, hsa_amd_memory_pool_allocate, pool, size, flags, ptr);
   if (result == HSA_STATUS_SUCCESS && *ptr) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    instance->pointer_sizes_[*ptr] = size;
+    instance->allocations_.add(reinterpret_cast<std::uint64_t>(*ptr),
+                               size,
+                               pool.handle,
+                               allocation_source::MEMORY_POOL);
     LOG_DETAIL("HSA Allocated {} bytes at {}", size, static_cast<void*>(*ptr));
   }
   return result;
@@ -827,13 +1612,33 @@ hsa_status_t nexus::hsa_memory_allocate(hsa_region_t region, size_t size, void**
   auto instance = get_instance();
   const auto result = hsa_core_call(instance, hsa_memory_allocate, region, size, ptr);
   if (result == HSA_STATUS_SUCCESS && *ptr) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    instance->pointer_sizes_[*ptr] = size;
+    instance->allocations_.add(reinterpret_cast<std::uint64_t>(*ptr),
+                               size,
+                               region.handle,
+                               allocation_source::REGION);
     LOG_DETAIL("HSA Allocated {} bytes at {}", size, static_cast<void*>(*ptr));
   }
   return result;
 }
 
+hsa_status_t nexus::hsa_amd_memory_pool_free(void* ptr) {
+  auto instance = get_instance();
+  // Forget the range before the runtime can hand it out again
+  if (ptr) {
+    instance->allocations_.remove(reinterpret_cast<std::uint64_t>(ptr));
+    LOG_DETAIL("HSA Freed {}", ptr);
+  }
+  return hsa_ext_call(instance, hsa_amd_memory_pool_free, ptr);
+}
+hsa_status_t nexus::hsa_memory_free(void* ptr) {
+  auto instance = get_instance();
+  if (ptr) {
+    instance->allocations_.remove(reinterpret_cast<std::uint64_t>(ptr));
+    LOG_DETAIL("HSA Freed {}", ptr);
+  }
+  return hsa_core_call(instance, hsa_memory_free, ptr);
+}
+
 hsa_status_t nexus::hsa_queue_create(hsa_agent_t agent,
                                      uint32_t size,
                                      hsa_queue_type32_t type,
@@ -861,7 +1666,8 @@ hsa_status_t nexus::hsa_queue_create(hsa_agent_t agent,
                           queue);
 
     if (result == HSA_STATUS_SUCCESS) {
-      auto result = instance->add_queue(*queue, agent);
+      void* intercepted = nullptr;
+      auto result = instance->add_queue(*queue, agent, &intercepted);
       if (result != HSA_STATUS_SUCCESS) {
         LOG_ERROR("Failed to add queue {} ", static_cast<int>(result));
       }
@@ -869,7 +1675,7 @@ hsa_status_t nexus::hsa_queue_create(hsa_agent_t agent,
                             hsa_amd_queue_intercept_register,
                             *queue,
                             nexus::on_submit_packet,
-                            reinterpret_cast<void*>(*queue));
+                            intercepted);
       if (result != HSA_STATUS_SUCCESS) {
         LOG_ERROR("Failed to register intercept callback with result of ",
                   static_cast<int>(result));
@@ -882,7 +1688,13 @@ hsa_status_t nexus::hsa_queue_create(hsa_agent_t agent,
 }
 hsa_status_t nexus::hsa_queue_destroy(hsa_queue_t* queue) {
   LOG_DETAIL("Destroying nexus queue");
-  return hsa_core_call(singleton_, hsa_queue_destroy, queue);
+  auto instance = get_instance();
+  const auto result = hsa_core_call(instance, hsa_queue_destroy, queue);
+  if (result == HSA_STATUS_SUCCESS) {
+    std::lock_guard<std::mutex> lock(instance->mm_mutex_);
+    instance->intercepted_queues_.erase(queue);
+  }
+  return result;
 }
 }  // namespace maestro
 
@@ -902,8 +1714,12 @@ PUBLIC_API bool OnLoad(HsaApiTable* table,
   return true;
 }
 
-PUBLIC_API void OnUnload() {}
+PUBLIC_API void OnUnload() {
+  maestro::nexus::finalize();
+}
 
 static void unload_me() __attribute__((destructor));
-void unload_me() {}
+void unload_me() {
+  maestro::nexus::finalize();
+}
 }
@@ -27,17 +27,39 @@
 #include <hsa/hsa_api_trace.h>
 #include <hsa/hsa_ven_amd_aqlprofile.h>
 #include <hsa/hsa_ven_amd_loader.h>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <nlohmann/json.hpp>
 #include <optional>
-#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include "allocation_registry.hpp"
+#include "code_object.hpp"
+#include "dispatch_pipeline.hpp"
+#include "dispatch_timer.hpp"
+#include "extraction_cache.hpp"
+#include "isa_store.hpp"
+#include "kernarg_scan.hpp"
+#include "kernel_cache.hpp"
+#include "kernel_dump.hpp"
+#include "kernel_filter.hpp"
+#include "line_table.hpp"
 #include "log.hpp"
+#include "mapping_index.hpp"
+#include "packet_batch.hpp"
+#include "search_index.hpp"
+#include "source_cache.hpp"
+#include "staging_pool.hpp"
+#include "symbol_table.hpp"
+#include "trace_writer.hpp"
 
 #include "include/kernelDB.h"
 
@@ -53,22 +75,6 @@
 
 namespace maestro {
 
-struct hsa_executable_symbol_hasher {
-  std::size_t operator()(const hsa_executable_symbol_t& symbol) const {
-    return std::hash<uint64_t>()(symbol.handle);
-  }
-};
-struct hsa_executable_symbol_compare {
-  using result_type = bool;
-  using first_argument_type = hsa_executable_symbol_t;
-  using second_argument_type = hsa_executable_symbol_t;
-
-  bool operator()(const hsa_executable_symbol_t& lhs,
-                  const hsa_executable_symbol_t& rhs) const {
-    return lhs.handle == rhs.handle;
-  }
-};
-
 struct hsa_agent_compare {
   bool operator()(const hsa_agent_t& lhs, const hsa_agent_t& rhs) const {
     return lhs.handle < rhs.handle;
@@ -143,19 +149,6 @@ struct HsaAgent {
     }
   }
 
-  static bool find_first_gpu_agent(const std::vector<HsaAgent>& agents,
-                                   HsaAgent& gpu_agent) {
-    auto it = std::find_if(
-        agents.begin(), agents.end(), [](const HsaAgent& agent) { return agent.is_gpu; });
-
-    if (it != agents.end()) {
-      gpu_agent = *it;
-      return true;
-    }
-
-    return false;
-  }
-
   static void get_all_agents(std::vector<HsaAgent>& agents) {
     auto agent_callback = [](hsa_agent_t agent, void* data) -> hsa_status_t {
       auto* agents_vector = static_cast<std::vector<HsaAgent>*>(data);
@@ -225,6 +218,7 @@ class nexus {
                              uint64_t runtime_version = 0,
                              uint64_t failed_tool_count = 0,
                              const char* const* failed_tool_names = nullptr);
+  static void finalize();
 
  private:
   nexus(HsaApiTable* table,
@@ -236,25 +230,74 @@ class nexus {
   void restore_hsa_api();
   void hook_api();
   void discover_agents();
+  void ensure_agents();
+  kernelDB::kernelDB& ensure_kdb();
+  nlohmann::json startup_stats();
+
+  // Runs f and records its duration for the startup report
+  template <typename F>
+  void timed_phase(const char* name, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::lock_guard g(startup_mutex_);
+    startup_phases_.push_back({name, static_cast<std::uint64_t>(ns), attached_});
+  }
   static void on_submit_packet(const void* in_packets,
                                uint64_t count,
                                uint64_t user_que_idx,
                                void* data,
                                hsa_amd_queue_intercept_packet_writer writer);
   void write_packets(hsa_queue_t* queue,
+                     hsa_agent_t agent,
                      const hsa_ext_amd_aql_pm4_packet_t* packet,
                      uint64_t count,
                      hsa_amd_queue_intercept_packet_writer writer);
-
-  hsa_status_t add_queue(hsa_queue_t* queue, hsa_agent_t agent);
+  void write_timed_packets(hsa_agent_t agent,
+                           const hsa_ext_amd_aql_pm4_packet_t* packet,
+                           uint64_t count,
+                           const std::uint32_t* dispatches,
+                           std::size_t num_dispatches,
+                           hsa_amd_queue_intercept_packet_writer writer);
+
+  hsa_status_t add_queue(hsa_queue_t* queue, hsa_agent_t agent, void** data);
+  static dispatch_timer_api make_timer_api();
+  nlohmann::json timing_stats();
+  nlohmann::json memory_stats();
+  nlohmann::json staging_stats();
+  nlohmann::json isa_stats();
+  nlohmann::json cache_stats();
+  nlohmann::json kernarg_stats();
+  void scan_kernargs(const hsa_kernel_dispatch_packet_t* packet);
+  // (symbol, kernel_object) of every kernel of an executable
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> executable_kernels(
+      hsa_executable_t executable);
+  void add_kernarg_sizes(hsa_code_object_reader_t code_object_reader,
+                         const void* code_object,
+                         std::size_t size);
+  // Call with executables_mutex_ held
+  std::uint32_t find_kernarg_size(hsa_executable_t executable,
+                                  const hsa_agent_t* agent,
+                                  const char* symbol_name);
+  static void write_stats_file(const std::filesystem::path& path,
+                               const nlohmann::json& stats);
   std::string packet_to_text(const hsa_ext_amd_aql_pm4_packet_t* packet);
-  std::optional<std::string> is_traceable_packet(
-      const hsa_ext_amd_aql_pm4_packet_t* packet);
+  std::optional<std::string> is_traceable_kernel(std::uint64_t kernel_object);
+  void process_dispatch(const dispatch_record& record);
   void send_message_and_wait(void* args);
 
   void dump_all_code_objects(const std::filesystem::path& path);
-  void dump_intercepted_packets(const std::filesystem::path& path);
-  nlohmann::json get_all_isa(const std::string& kernel_name);
+  void extract_kernel(std::uint64_t kernel_object, const std::string& kernel_name);
+  void write_kernel_locked(kernel_record& record, const isa_block* block);
+  std::optional<code_object_hash> cache_key_for(std::uint64_t kernel_object,
+                                                const std::string& kernel_name);
+  void ingest_locked(code_object_location& location);
+  void ingest_for_kernel_locked(std::uint64_t kernel_object);
+  // With lines, also records the source line of every instruction
+  const isa_block* get_all_isa(const std::string& kernel_name,
+                               line_table* lines = nullptr);
   static hsa_status_t hsa_queue_create(hsa_agent_t agent,
                                        uint32_t size,
                                        hsa_queue_type32_t type,
@@ -270,6 +313,8 @@ class nexus {
                                                    uint32_t flags,
                                                    void** ptr);
   static hsa_status_t hsa_memory_allocate(hsa_region_t region, size_t size, void** ptr);
+  static hsa_status_t hsa_amd_memory_pool_free(void* ptr);
+  static hsa_status_t hsa_memory_free(void* ptr);
   static hsa_status_t hsa_queue_destroy(hsa_queue_t* queue);
   static hsa_status_t hsa_code_object_reader_create_from_file(
       hsa_file_t file,
@@ -278,6 +323,15 @@ class nexus {
       const void* code_object,
       size_t size,
       hsa_code_object_reader_t* code_object_reader);
+  static hsa_status_t hsa_code_object_reader_destroy(
+      hsa_code_object_reader_t code_object_reader);
+  static hsa_status_t hsa_executable_load_agent_code_object(
+      hsa_executable_t executable,
+      hsa_agent_t agent,
+      hsa_code_object_reader_t code_object_reader,
+      const char* options,
+      hsa_loaded_code_object_t* loaded_code_object);
+  static hsa_status_t hsa_executable_destroy(hsa_executable_t executable);
 
   static hsa_status_t hsa_executable_get_symbol_by_name(hsa_executable_t executable,
                                                         const char* symbol_name,
@@ -315,34 +369,108 @@ class nexus {
         header_scacquire_scope_mask);
   }
 
-  std::string get_kernel_name(const std::uint64_t kernel_object);
+  std::string_view get_kernel_name(const std::uint64_t kernel_object);
+
+  // Copies device memory into a pinned buffer from the staging pool of gpu.
+  // Empty on failure.
+  staging_buffer copy_to_host(hsa_agent_t gpu, const void* device_ptr, size_t size);
 
  private:
+  // Only taken while the instance is created
   static std::mutex mutex_;
-  static std::shared_mutex stop_mutex_;
-  static nexus* singleton_;
+  static std::atomic<nexus*> singleton_;
 
   std::vector<HsaAgent> agents_;
+  // Handles of the memory pools and regions of GPU agents
+  std::unordered_set<std::uint64_t> device_pools_;
+
+  // Pinned host buffers for device-to-host copies, per GPU agent
+  struct staging_target {
+    hsa_agent_t gpu;
+    hsa_amd_memory_pool_t host_pool;
+    std::unique_ptr<staging_pool> staging;
+  };
+  std::unordered_map<std::uint64_t, std::unique_ptr<staging_target>> staging_targets_;
+  std::optional<hsa_amd_memory_pool_t> nearest_host_pool(hsa_agent_t gpu);
+  void create_staging_pools();
 
   HsaApiTable* api_table_;
   HsaApiTable rocr_api_table_;
-  nlohmann::json json_;
-  HsaAgent gpu_agent_;
+  std::unique_ptr<trace_writer> trace_writer_;
+  std::unique_ptr<dispatch_pipeline> pipeline_;
+  hsa_agent_t gpu_agent_{};
 
   std::map<hsa_queue_t*, std::pair<unsigned int, std::uint64_t>> queue_ids_;
   std::map<hsa_agent_t, std::string, hsa_agent_compare> agents_names_;
-  std::unordered_map<hsa_executable_symbol_t,
-                     std::string,
-                     hsa_executable_symbol_hasher,
-                     hsa_executable_symbol_compare>
-      symbols_names_;
-
+  symbol_table symbol_table_;
+  kernel_cache kernel_cache_;
+  std::unique_ptr<kernel_filter> kernel_filter_;
+  std::unique_ptr<source_cache> source_cache_;
+  std::unique_ptr<search_index> search_index_;
+  mapping_index mappings_;
+  code_object_registry code_objects_;
+  bool eager_ingest_{false};
+
+  // Loader bookkeeping, written by the executable and reader hooks
+  std::mutex executables_mutex_;
   std::unordered_map<std::string, hsa_executable_t> kernels_executables_;
-
-  std::unordered_map<std::uint64_t, hsa_executable_symbol_t> handles_symbols_;
-  std::unordered_map<void*, std::size_t> pointer_sizes_;
+  std::unordered_map<std::uint64_t, std::shared_ptr<code_object_location>>
+      readers_code_objects_;
+  std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<code_object_location>>>
+      executables_code_objects_;
+  // Content hashes behind each reader and executable, for cache keys
+  std::unordered_map<std::uint64_t, code_object_hash> readers_hashes_;
+  std::unordered_map<std::uint64_t, std::vector<code_object_hash>> executables_hashes_;
+  // Explicit kernarg bytes by kernel and descriptor name, for the kernarg scan.
+  // Kept per code object since specializations and per-arch builds reuse
+  // kernel names; executables record the agent each object was loaded for.
+  using kernarg_sizes = std::unordered_map<std::string, std::uint32_t>;
+  std::unordered_map<std::uint64_t, std::shared_ptr<const kernarg_sizes>>
+      readers_kernarg_sizes_;
+  std::unordered_map<
+      std::uint64_t,
+      std::vector<std::pair<std::uint64_t, std::shared_ptr<const kernarg_sizes>>>>
+      executables_kernarg_sizes_;
+
+  allocation_registry allocations_;
+  std::unique_ptr<kernarg_scanner> kernarg_scanner_;
+
+  std::unique_ptr<dispatch_timer> timer_;
+  // Passed as the interception callback data of each queue
+  struct intercepted_queue {
+    hsa_queue_t* queue;
+    hsa_agent_t agent;
+  };
+  std::unordered_map<hsa_queue_t*, std::unique_ptr<intercepted_queue>>
+      intercepted_queues_;
   std::mutex mm_mutex_;
+
+  // Disassembly and kernel extraction; may take executables_mutex_ inside
+  std::mutex kdb_mutex_;
+  std::unordered_set<std::string> extracted_kernels_;
   std::unique_ptr<kernelDB::kernelDB> kdb_;
+
+  // Both OnUnload and the library destructor finalize; only the first runs
+  std::atomic<bool> finalized_{false};
+
+  // NEXUS_FAST_ATTACH defers agents and kernelDB until first use
+  bool fast_attach_{false};
+  std::once_flag agents_once_;
+  std::once_flag kdb_once_;
+  struct startup_phase {
+    const char* name;
+    std::uint64_t ns;
+    bool deferred;  // ran after the constructor returned
+  };
+  std::mutex startup_mutex_;
+  std::vector<startup_phase> startup_phases_;
+  bool attached_{false};
+  // ISA of extracted kernels, shared between identical bodies
+  isa_store isa_store_;
+  bool shared_isa_{false};
+  // Extracted kernels persisted across runs (NEXUS_CACHE_DIR)
+  std::unique_ptr<extraction_cache> cache_;
+  std::string cache_salt_;
 };
 
 }  // namespace maestro
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "packet_batch.hpp"
+
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace maestro {
+namespace detail {
+
+static std::uint8_t header_type(const unsigned char* slot) {
+  return slot[0];
+}
+
+std::size_t find_dispatches_scalar(const void* packets,
+                                   std::size_t count,
+                                   std::uint32_t* out) {
+  const auto* slots = static_cast<const unsigned char*>(packets);
+  std::size_t found = 0;
+  // Branch-free: always store, only advance on a dispatch
+  for (std::size_t i = 0; i < count; i++) {
+    out[found] = static_cast<std::uint32_t>(i);
+    found += header_type(slots + i * aql_packet_size) == aql_kernel_dispatch_type;
+  }
+  return found;
+}
+
+#if defined(__x86_64__)
+
+// Gathers the header dword of 8 slots at a time and compares the type byte
+__attribute__((target("avx2,bmi"))) std::size_t find_dispatches_avx2(
+    const void* packets,
+    std::size_t count,
+    std::uint32_t* out) {
+  const auto* slots = static_cast<const unsigned char*>(packets);
+  const __m256i offsets = _mm256_setr_epi32(0, 64, 128, 192, 256, 320, 384, 448);
+  const __m256i type_mask = _mm256_set1_epi32(0xff);
+  const __m256i dispatch = _mm256_set1_epi32(aql_kernel_dispatch_type);
+
+  std::size_t found = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const auto* base = reinterpret_cast<const int*>(slots + i * aql_packet_size);
+    const __m256i headers = _mm256_i32gather_epi32(base, offsets, 1);
+    const __m256i types = _mm256_and_si256(headers, type_mask);
+    auto mask = static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(types, dispatch))));
+    while (mask) {
+      out[found++] = static_cast<std::uint32_t>(i + _tzcnt_u32(mask));
+      mask &= mask - 1;
+    }
+  }
+  for (; i < count; i++) {
+    out[found] = static_cast<std::uint32_t>(i);
+    found += header_type(slots + i * aql_packet_size) == aql_kernel_dispatch_type;
+  }
+  return found;
+}
+
+#else
+
+std::size_t find_dispatches_avx2(const void* packets,
+                                 std::size_t count,
+                                 std::uint32_t* out) {
+  return find_dispatches_scalar(packets, count, out);
+}
+
+#endif
+
+bool has_avx2() {
+#if defined(__x86_64__)
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+}  // namespace detail
+
+std::size_t find_dispatches(const void* packets, std::size_t count, std::uint32_t* out) {
+  // Gathers do not pay off for the common one-packet submission
+  if (count >= 8 && detail::has_avx2()) {
+    return detail::find_dispatches_avx2(packets, count, out);
+  }
+  return detail::find_dispatches_scalar(packets, count, out);
+}
+
+}  // namespace maestro
@@ -0,0 +1,52 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace maestro {
+
+// Size of an AQL packet slot
+inline constexpr std::size_t aql_packet_size = 64;
+// HSA_PACKET_TYPE_KERNEL_DISPATCH, the low byte of the packet header
+inline constexpr std::uint8_t aql_kernel_dispatch_type = 2;
+
+// Classifies a batch of AQL packets by header type and writes the indices of
+// kernel dispatches to out (room for count entries). Returns how many were
+// found. Uses AVX2 gathers when the CPU supports them.
+std::size_t find_dispatches(const void* packets, std::size_t count, std::uint32_t* out);
+
+namespace detail {
+std::size_t find_dispatches_scalar(const void* packets,
+                                   std::size_t count,
+                                   std::uint32_t* out);
+std::size_t find_dispatches_avx2(const void* packets,
+                                 std::size_t count,
+                                 std::uint32_t* out);
+bool has_avx2();
+}  // namespace detail
+
+}  // namespace maestro
@@ -0,0 +1,175 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "search_index.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+#include "log.hpp"
+
+namespace maestro {
+
+namespace fs = std::filesystem;
+
+static bool try_open(const std::string& path) {
+  std::ifstream f(path);
+  return f.good();
+}
+
+search_index::search_index(const char* prefixes) {
+  if (!prefixes) {
+    return;
+  }
+  std::stringstream ss(prefixes);
+  std::string root;
+  while (std::getline(ss, root, ':')) {
+    if (!root.empty()) {
+      roots_.push_back(root);
+    }
+  }
+}
+
+search_index::prefix_index search_index::scan(const std::string& root) {
+  prefix_index index;
+  index.recursive = root.back() == '*';
+  index.root = index.recursive ? root.substr(0, root.size() - 1) : root;
+
+  const auto add = [&index](const fs::directory_entry& entry) {
+    std::error_code ec;
+    if (!entry.is_regular_file(ec)) {
+      return;
+    }
+    const auto& path = entry.path();
+    // First hit wins, as it did when the prefixes were walked per lookup
+    index.by_filename.try_emplace(path.filename().string(), path.string());
+    index.by_stem.try_emplace(path.stem().string(), path.string());
+  };
+
+  std::error_code ec;
+  if (index.recursive) {
+    for (fs::recursive_directory_iterator
+             it(index.root, fs::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end;
+         it.increment(ec)) {
+      add(*it);
+    }
+  } else {
+    for (fs::directory_iterator it(index.root, ec), end; !ec && it != end;
+         it.increment(ec)) {
+      add(*it);
+    }
+  }
+  if (ec) {
+    LOG_WARN("Failed to scan search prefix {}: {}", index.root, ec.message());
+  }
+  LOG_DETAIL("Indexed {} files under {}", index.by_filename.size(), index.root);
+  return index;
+}
+
+void search_index::rescan_locked() {
+  std::vector<std::future<prefix_index>> scans;
+  scans.reserve(roots_.size());
+  for (const auto& root : roots_) {
+    scans.push_back(std::async(std::launch::async, &search_index::scan, root));
+  }
+
+  prefixes_.clear();
+  for (auto& scan : scans) {
+    prefixes_.push_back(scan.get());
+  }
+  scanned_ = true;
+  last_scan_ = std::chrono::steady_clock::now();
+}
+
+std::optional<std::string> search_index::lookup_locked(
+    const std::string& filename) const {
+  const fs::path target_path(filename);
+  const auto target_filename = target_path.filename().string();
+  const auto target_stem = target_path.stem().string();
+
+  for (const auto& prefix : prefixes_) {
+    if (prefix.recursive) {
+      // The whole requested name is compared against a file name, so only
+      // names without directories can match that way
+      if (target_filename == filename) {
+        if (auto it = prefix.by_filename.find(filename); it != prefix.by_filename.end()) {
+          return it->second;
+        }
+      }
+    } else {
+      const auto full_path = prefix.root + "/" + filename;
+      if (try_open(full_path)) {
+        return full_path;
+      }
+    }
+    if (auto it = prefix.by_stem.find(target_stem); it != prefix.by_stem.end()) {
+      return it->second;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> search_index::find(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (auto it = resolved_.find(filename); it != resolved_.end()) {
+    return it->second;
+  }
+
+  // 1. Try original path
+  if (try_open(filename)) {
+    return resolved_[filename] = filename;
+  }
+
+  // 2. Try the search prefixes
+  if (roots_.empty()) {
+    LOG_WARN("Cannot open file {} and NEXUS_EXTRA_SEARCH_PREFIX not set", filename);
+    return resolved_[filename] = std::nullopt;
+  }
+
+  if (!scanned_) {
+    rescan_locked();
+  }
+  auto result = lookup_locked(filename);
+
+  // Files generated after the last scan (e.g. JIT sources) show up on a later
+  // miss; rescans are rate limited so a burst of misses costs one walk
+  using namespace std::chrono_literals;
+  if (!result && std::chrono::steady_clock::now() - last_scan_ > 1s) {
+    rescan_locked();
+    result = lookup_locked(filename);
+  }
+
+  if (!result) {
+    LOG_WARN("Cannot find file {} in any of the NEXUS_EXTRA_SEARCH_PREFIX paths",
+             filename);
+  }
+  return resolved_[filename] = result;
+}
+
+}  // namespace maestro
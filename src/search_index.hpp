@@ -0,0 +1,67 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace maestro {
+
+// Resolves source file names against the NEXUS_EXTRA_SEARCH_PREFIX list.
+// Prefixes are scanned once (in parallel) into filename/stem indices and every
+// requested name is memoized, including names that could not be found.
+class search_index {
+ public:
+  // `prefixes` is the colon-separated NEXUS_EXTRA_SEARCH_PREFIX value; entries
+  // ending in '*' are searched recursively.
+  explicit search_index(const char* prefixes);
+
+  std::optional<std::string> find(const std::string& filename);
+
+ private:
+  struct prefix_index {
+    std::string root;
+    bool recursive{false};
+    std::unordered_map<std::string, std::string> by_filename;
+    std::unordered_map<std::string, std::string> by_stem;
+  };
+
+  static prefix_index scan(const std::string& root);
+  void rescan_locked();
+  std::optional<std::string> lookup_locked(const std::string& filename) const;
+
+  std::vector<std::string> roots_;
+  std::vector<prefix_index> prefixes_;
+  bool scanned_{false};
+  std::chrono::steady_clock::time_point last_scan_;
+  std::unordered_map<std::string, std::optional<std::string>> resolved_;
+  std::mutex mutex_;
+};
+
+}  // namespace maestro
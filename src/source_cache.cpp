@@ -0,0 +1,164 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "source_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "log.hpp"
+
+namespace maestro {
+
+// Records the offset following every '\n', 16 bytes at a time where possible
+static void index_lines(const char* data,
+                        std::size_t size,
+                        std::vector<std::size_t>& starts) {
+  if (size == 0) {
+    return;
+  }
+  starts.reserve(size / 32 + 1);
+  starts.push_back(0);
+
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i newline = _mm_set1_epi8('\n');
+  for (; i + 16 <= size; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+    while (mask) {
+      const auto next = i + __builtin_ctz(mask) + 1;
+      if (next < size) {
+        starts.push_back(next);
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; i < size; i++) {
+    if (data[i] == '\n' && i + 1 < size) {
+      starts.push_back(i + 1);
+    }
+  }
+}
+
+std::shared_ptr<const source_file> source_file::map(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return nullptr;
+  }
+
+  std::shared_ptr<source_file> file(new source_file());
+  file->size_ = static_cast<std::size_t>(st.st_size);
+  file->mtime_ = st.st_mtim;
+
+  if (file->size_ > 0) {
+    void* data = mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      return nullptr;
+    }
+    file->data_ = static_cast<const char*>(data);
+  }
+  ::close(fd);
+
+  index_lines(file->data_, file->size_, file->line_starts_);
+  return file;
+}
+
+source_file::~source_file() {
+  if (data_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+std::optional<std::string_view> source_file::line(std::size_t line_number) const {
+  if (line_number >= line_starts_.size()) {
+    return std::nullopt;
+  }
+  const auto begin = line_starts_[line_number];
+  auto end =
+      line_number + 1 < line_starts_.size() ? line_starts_[line_number + 1] : size_;
+  if (end > begin && data_[end - 1] == '\n') {
+    end--;
+  }
+  return std::string_view(data_ + begin, end - begin);
+}
+
+std::shared_ptr<const source_file> source_cache::open(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(path);
+  if (it != entries_.end()) {
+    if (it->second.file->matches(st.st_size, st.st_mtim)) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return it->second.file;
+    }
+    LOG_DETAIL("Source file {} changed, mapping it again", path);
+    bytes_ -= it->second.file->footprint();
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+  }
+
+  auto file = source_file::map(path);
+  if (!file) {
+    LOG_WARN("Failed to open file {}", path);
+    return nullptr;
+  }
+
+  lru_.push_front(path);
+  entries_.emplace(path, entry{file, lru_.begin()});
+  bytes_ += file->footprint();
+  evict_locked();
+  return file;
+}
+
+void source_cache::evict_locked() {
+  // Always keep the most recent file even if it alone exceeds the budget
+  while (bytes_ > max_bytes_ && lru_.size() > 1) {
+    auto it = entries_.find(lru_.back());
+    bytes_ -= it->second.file->footprint();
+    LOG_DETAIL("Evicting source file {}", lru_.back());
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+}  // namespace maestro
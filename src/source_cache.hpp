@@ -0,0 +1,103 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace maestro {
+
+// A read-only mapping of a source file plus the offset of every line start.
+class source_file {
+ public:
+  static std::shared_ptr<const source_file> map(const std::string& path);
+  ~source_file();
+
+  source_file(const source_file&) = delete;
+  source_file& operator=(const source_file&) = delete;
+
+  // Zero-based line without its terminating newline, in O(1)
+  std::optional<std::string_view> line(std::size_t line_number) const;
+  std::size_t line_count() const { return line_starts_.size(); }
+
+  // Mapped bytes plus the line index
+  std::size_t footprint() const {
+    return size_ + line_starts_.capacity() * sizeof(std::size_t);
+  }
+  bool matches(off_t size, const timespec& mtime) const {
+    return static_cast<off_t>(size_) == size && mtime_.tv_sec == mtime.tv_sec &&
+           mtime_.tv_nsec == mtime.tv_nsec;
+  }
+
+ private:
+  source_file() = default;
+
+  const char* data_{nullptr};
+  std::size_t size_{0};
+  timespec mtime_{};
+  std::vector<std::size_t> line_starts_;
+};
+
+// Maps each source file once and serves individual lines from the mapping.
+// Entries are revalidated against the file's size and mtime on every open()
+// and the least recently used files are unmapped past `max_bytes`.
+class source_cache {
+ public:
+  explicit source_cache(std::size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Callers keep the returned pointer while they read lines; eviction only
+  // drops the cache's reference.
+  std::shared_ptr<const source_file> open(const std::string& path);
+
+  std::size_t bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+ private:
+  struct entry {
+    std::shared_ptr<const source_file> file;
+    std::list<std::string>::iterator lru;
+  };
+
+  void evict_locked();
+
+  const std::size_t max_bytes_;
+  mutable std::mutex mutex_;
+  std::size_t bytes_{0};
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, entry> entries_;
+};
+
+}  // namespace maestro
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "staging_pool.hpp"
+
+#include <bit>
+#include <algorithm>
+#include <utility>
+
+namespace maestro {
+
+staging_buffer& staging_buffer::operator=(staging_buffer&& other) noexcept {
+  if (this != &other) {
+    reset();
+    pool_ = std::exchange(other.pool_, nullptr);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+void staging_buffer::reset() {
+  if (data_) {
+    pool_->give_back(data_, capacity_);
+  }
+  pool_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+}
+
+staging_pool::staging_pool(const staging_pool_api& api, std::size_t max_retained)
+    : api_(api), max_retained_(max_retained) {}
+
+staging_buffer staging_pool::acquire(std::size_t size) {
+  acquires_.fetch_add(1, std::memory_order_relaxed);
+  const auto bits =
+      std::max<unsigned>(std::bit_width(size ? size - 1 : 0), min_class_bits);
+  const bool pooled = bits <= max_class_bits;
+  const std::size_t capacity = pooled ? std::size_t{1} << bits : size;
+
+  void* data = nullptr;
+  if (pooled) {
+    std::lock_guard g(mutex_);
+    auto& list = free_[bits - min_class_bits];
+    if (!list.empty()) {
+      data = list.back();
+      list.pop_back();
+    }
+  }
+
+  if (data) {
+    reuses_.fetch_add(1, std::memory_order_relaxed);
+    retained_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+  } else {
+    if (!api_.allocate(api_.context, capacity, &data) || !data) {
+      failures_.fetch_add(1, std::memory_order_relaxed);
+      return {};
+    }
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+  in_use_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+  update_peak();
+  return staging_buffer(this, data, size, capacity);
+}
+
+void staging_pool::give_back(void* data, std::size_t capacity) {
+  in_use_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+  const auto bits = std::bit_width(capacity - 1);
+  const bool pooled = std::has_single_bit(capacity) && bits >= min_class_bits &&
+                      bits <= max_class_bits;
+  if (pooled) {
+    std::lock_guard g(mutex_);
+    if (retained_bytes_.load(std::memory_order_relaxed) + capacity <= max_retained_) {
+      free_[bits - min_class_bits].push_back(data);
+      retained_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+      return;
+    }
+  }
+  api_.free(api_.context, data);
+  frees_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void staging_pool::update_peak() {
+  const auto total = retained_bytes_.load(std::memory_order_relaxed) +
+                     in_use_bytes_.load(std::memory_order_relaxed);
+  auto peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (total > peak &&
+         !peak_bytes_.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+  }
+}
+
+void staging_pool::release() {
+  std::lock_guard g(mutex_);
+  for (std::size_t i = 0; i < num_classes; i++) {
+    for (void* data : free_[i]) {
+      api_.free(api_.context, data);
+      frees_.fetch_add(1, std::memory_order_relaxed);
+    }
+    retained_bytes_.fetch_sub(free_[i].size() << (i + min_class_bits),
+                              std::memory_order_relaxed);
+    free_[i].clear();
+  }
+}
+
+staging_pool::counters staging_pool::get_counters() const {
+  return {acquires_.load(std::memory_order_relaxed),
+          reuses_.load(std::memory_order_relaxed),
+          allocations_.load(std::memory_order_relaxed),
+          frees_.load(std::memory_order_relaxed),
+          failures_.load(std::memory_order_relaxed),
+          retained_bytes_.load(std::memory_order_relaxed),
+          in_use_bytes_.load(std::memory_order_relaxed),
+          peak_bytes_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace maestro
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace maestro {
+
+// Allocator behind a staging pool. nexus binds it to one host memory pool;
+// benchmarks use plain host memory.
+struct staging_pool_api {
+  bool (*allocate)(void* context, std::size_t size, void** ptr);
+  void (*free)(void* context, void* ptr);
+  void* context;
+};
+
+class staging_pool;
+
+// A pinned host buffer on loan from a staging_pool; returned when destroyed.
+class staging_buffer {
+ public:
+  staging_buffer() = default;
+  staging_buffer(staging_pool* pool, void* data, std::size_t size, std::size_t capacity)
+      : pool_(pool), data_(data), size_(size), capacity_(capacity) {}
+  staging_buffer(staging_buffer&& other) noexcept { *this = std::move(other); }
+  staging_buffer& operator=(staging_buffer&& other) noexcept;
+  ~staging_buffer() { reset(); }
+
+  void* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  explicit operator bool() const { return data_ != nullptr; }
+
+  void reset();
+
+ private:
+  staging_pool* pool_{nullptr};
+  void* data_{nullptr};
+  std::size_t size_{0};
+  std::size_t capacity_{0};
+};
+
+// Size-classed pool of pinned staging buffers. Requests are rounded up to a
+// power of two between 4 KiB and 64 MiB and served from that class's free
+// list; larger ones get a buffer of their own. Returned buffers are kept
+// until the pool holds max_retained bytes.
+class staging_pool {
+ public:
+  struct counters {
+    std::uint64_t acquires;
+    std::uint64_t reuses;
+    std::uint64_t allocations;
+    std::uint64_t frees;
+    std::uint64_t failures;
+    std::uint64_t retained_bytes;   // idle in the free lists
+    std::uint64_t in_use_bytes;     // on loan
+    std::uint64_t peak_bytes;       // retained + in use
+  };
+
+  staging_pool(const staging_pool_api& api, std::size_t max_retained);
+  ~staging_pool() { release(); }
+
+  staging_pool(const staging_pool&) = delete;
+  staging_pool& operator=(const staging_pool&) = delete;
+
+  // An empty buffer when the allocation fails
+  staging_buffer acquire(std::size_t size);
+
+  // Frees every idle buffer
+  void release();
+
+  counters get_counters() const;
+
+ private:
+  friend class staging_buffer;
+
+  static constexpr unsigned min_class_bits = 12;
+  static constexpr unsigned max_class_bits = 26;
+  static constexpr std::size_t num_classes = max_class_bits - min_class_bits + 1;
+
+  void give_back(void* data, std::size_t capacity);
+  void update_peak();
+
+  staging_pool_api api_;
+  std::size_t max_retained_;
+
+  mutable std::mutex mutex_;
+  std::array<std::vector<void*>, num_classes> free_;
+
+  std::atomic<std::uint64_t> acquires_{0};
+  std::atomic<std::uint64_t> reuses_{0};
+  std::atomic<std::uint64_t> allocations_{0};
+  std::atomic<std::uint64_t> frees_{0};
+  std::atomic<std::uint64_t> failures_{0};
+  std::atomic<std::uint64_t> retained_bytes_{0};
+  std::atomic<std::uint64_t> in_use_bytes_{0};
+  std::atomic<std::uint64_t> peak_bytes_{0};
+};
+
+}  // namespace maestro
@@ -0,0 +1,82 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "symbol_table.hpp"
+
+namespace maestro {
+
+std::string_view symbol_table::intern(std::string_view s) {
+  return *strings_.emplace(s).first;
+}
+
+void symbol_table::add_symbol(std::uint64_t symbol,
+                              std::string_view mangled,
+                              std::string_view name,
+                              std::uint32_t kernarg_size) {
+  std::lock_guard g(mutex_);
+  if (by_symbol_.contains(symbol)) {
+    return;
+  }
+  const auto* record = &symbols_.emplace_back(
+      kernel_symbol{symbol, intern(mangled), intern(name), kernarg_size});
+  by_symbol_[symbol] = record;
+
+  const auto [first, last] = pending_.equal_range(symbol);
+  for (auto it = first; it != last; ++it) {
+    by_kernel_object_.insert(it->second, record);
+  }
+  pending_.erase(symbol);
+}
+
+bool symbol_table::has_symbol(std::uint64_t symbol) const {
+  std::lock_guard g(mutex_);
+  return by_symbol_.contains(symbol);
+}
+
+void symbol_table::add_kernel_object(std::uint64_t kernel_object, std::uint64_t symbol) {
+  std::lock_guard g(mutex_);
+  auto it = by_symbol_.find(symbol);
+  if (it == by_symbol_.end()) {
+    pending_.emplace(symbol, kernel_object);
+    return;
+  }
+  by_kernel_object_.insert(kernel_object, it->second);
+}
+
+void symbol_table::retire(std::uint64_t symbol, std::uint64_t kernel_object) {
+  std::lock_guard g(mutex_);
+  by_symbol_.erase(symbol);
+  pending_.erase(symbol);
+  const auto* record = by_kernel_object_.find(kernel_object);
+  if (record && record->symbol == symbol) {
+    by_kernel_object_.erase(kernel_object);
+  }
+}
+
+std::size_t symbol_table::size() const {
+  std::lock_guard g(mutex_);
+  return by_kernel_object_.size();
+}
+
+}  // namespace maestro
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "concurrent_map.hpp"
+
+namespace maestro {
+
+// What a dispatch needs to know about its kernel_object. Names point into the
+// table's intern pool and live as long as the table.
+struct kernel_symbol {
+  std::uint64_t symbol;
+  std::string_view mangled;
+  std::string_view name;  // demangled, " [clone ...]" stripped
+  std::uint32_t kernarg_size;  // explicit arguments only, 0 when unknown
+};
+
+// kernel_object -> kernel_symbol map for the dispatch path. Registration
+// (symbol lookups, rare) takes a mutex; find() is wait-free and never
+// allocates.
+class symbol_table {
+ public:
+  // Whether add_symbol() already recorded this symbol handle
+  bool has_symbol(std::uint64_t symbol) const;
+
+  // Records the names of an executable symbol, as seen by
+  // hsa_executable_get_symbol_by_name. Later calls for the same handle are
+  // ignored until the handle is retired.
+  void add_symbol(std::uint64_t symbol,
+                  std::string_view mangled,
+                  std::string_view name,
+                  std::uint32_t kernarg_size = 0);
+
+  // Records the kernel_object of a symbol, as seen by
+  // hsa_executable_symbol_get_info. Either call may come first.
+  void add_kernel_object(std::uint64_t kernel_object, std::uint64_t symbol);
+
+  // Forgets a symbol and its kernel_object when their executable is
+  // destroyed, since the runtime hands both handles out again. The record
+  // itself stays alive for dispatches that already looked it up.
+  void retire(std::uint64_t symbol, std::uint64_t kernel_object);
+
+  const kernel_symbol* find(std::uint64_t kernel_object) const {
+    return by_kernel_object_.find(kernel_object);
+  }
+
+  std::size_t size() const;
+
+ private:
+  std::string_view intern(std::string_view s);
+
+  mutable std::mutex mutex_;
+  concurrent_map<const kernel_symbol> by_kernel_object_;
+
+  std::unordered_set<std::string> strings_;
+  std::deque<kernel_symbol> symbols_;
+  std::unordered_map<std::uint64_t, const kernel_symbol*> by_symbol_;
+  // kernel_objects whose symbol name is not known yet
+  std::unordered_multimap<std::uint64_t, std::uint64_t> pending_;
+};
+
+}  // namespace maestro
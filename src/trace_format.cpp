@@ -0,0 +1,414 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "trace_format.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+
+namespace maestro {
+
+namespace {
+
+constexpr std::size_t header_size = sizeof(nxb_magic) + 8;
+// Version 2 added the per-instruction source index
+constexpr std::uint32_t format_version = 2;
+constexpr std::size_t trailer_size = 8 + sizeof(nxb_trailer_magic);
+
+void put_u64(std::string& out, std::uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+std::uint64_t get_u64(const unsigned char* p) {
+  std::uint64_t value = 0;
+  for (int i = 7; i >= 0; i--) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^
+         static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}  // namespace
+
+nlohmann::json to_json(const kernel_record& record) {
+  nlohmann::json json;
+  json["lines"] = record.lines;
+  json["files"] = record.files;
+  json["hip"] = record.hip;
+  if (record.assembly_ref.empty()) {
+    json["assembly"] = record.assembly;
+  } else {
+    json["assembly_ref"] = record.assembly_ref;
+  }
+  json["source_index"] = record.source_index;
+  json["signature"] = record.signature;
+  return json;
+}
+
+void put_varint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+    const auto byte = *p++;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+nxb_encoder::nxb_encoder() : offset_(header_size) {}
+
+std::string nxb_encoder::header() const {
+  std::string out(nxb_magic, sizeof(nxb_magic));
+  put_u64(out, format_version);
+  return out;
+}
+
+std::uint32_t nxb_encoder::intern(std::string_view s) {
+  auto it = ids_.find(s);
+  if (it == ids_.end()) {
+    it = ids_.emplace(s, static_cast<std::uint32_t>(ids_.size())).first;
+    // Position within the pending body; fixed up when the block is written
+    string_offsets_.push_back(pending_strings_.size());
+    put_varint(pending_strings_, s.size());
+    pending_strings_ += s;
+    string_bytes_ += s.size();
+    num_pending_++;
+  }
+  return it->second;
+}
+
+void nxb_encoder::append_block(nxb_block type,
+                               const std::string& payload,
+                               std::string& out) {
+  out.push_back(static_cast<char>(type));
+  put_varint(out, payload.size());
+  out += payload;
+}
+
+void nxb_encoder::encode(const kernel_record& record, std::string& out) {
+  std::string kernel;
+  put_varint(kernel, intern(record.name));
+  put_varint(kernel, intern(record.signature));
+
+  put_varint(kernel, record.lines.size());
+  std::int64_t previous = 0;
+  for (const auto line : record.lines) {
+    put_varint(kernel, zigzag(static_cast<std::int64_t>(line) - previous));
+    previous = line;
+  }
+  const auto put_strings = [&](const auto& strings) {
+    put_varint(kernel, strings.size());
+    for (const auto& s : strings) {
+      put_varint(kernel, intern(s));
+    }
+  };
+  put_strings(record.files);
+  put_strings(record.hip);
+  put_strings(record.assembly);
+  put_varint(kernel, record.source_index.size());
+  for (const auto index : record.source_index) {
+    put_varint(kernel, static_cast<std::uint64_t>(index + 1));
+  }
+
+  if (num_pending_) {
+    std::string payload;
+    put_varint(payload, num_pending_);
+    const auto body_offset = payload.size();
+    payload += pending_strings_;
+
+    std::string block_header(1, static_cast<char>(nxb_block::STRINGS));
+    put_varint(block_header, payload.size());
+    const auto base = offset_ + block_header.size() + body_offset;
+    const auto first = string_offsets_.size() - num_pending_;
+    for (auto i = first; i < string_offsets_.size(); i++) {
+      string_offsets_[i] += base;
+    }
+
+    out += block_header;
+    out += payload;
+    offset_ += block_header.size() + payload.size();
+    pending_strings_.clear();
+    num_pending_ = 0;
+  }
+
+  kernels_.emplace_back(ids_.at(record.name), offset_);
+  const auto before = out.size();
+  append_block(nxb_block::KERNEL, kernel, out);
+  offset_ += out.size() - before;
+}
+
+void nxb_encoder::finish(std::string& out) {
+  const auto index_offset = offset_;
+  out.append(nxb_index_magic, sizeof(nxb_index_magic));
+  put_u64(out, string_offsets_.size());
+  put_u64(out, kernels_.size());
+  for (const auto offset : string_offsets_) {
+    put_u64(out, offset);
+  }
+  for (const auto& [name, offset] : kernels_) {
+    put_u64(out, name);
+    put_u64(out, offset);
+  }
+  put_u64(out, index_offset);
+  out.append(nxb_trailer_magic, sizeof(nxb_trailer_magic));
+}
+
+std::optional<nxb_reader> nxb_reader::open(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < header_size) {
+    ::close(fd);
+    return std::nullopt;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  nxb_reader reader;
+  reader.data_ = static_cast<const unsigned char*>(data);
+  reader.size_ = st.st_size;
+  if (std::memcmp(reader.data_, nxb_magic, sizeof(nxb_magic)) != 0) {
+    return std::nullopt;
+  }
+  reader.version_ = get_u64(reader.data_ + sizeof(nxb_magic));
+  if (reader.version_ == 0 || reader.version_ > format_version) {
+    return std::nullopt;
+  }
+  if (!reader.load_index()) {
+    reader.recovered_ = true;
+    if (!reader.scan_blocks()) {
+      return std::nullopt;
+    }
+  }
+  return reader;
+}
+
+nxb_reader::nxb_reader(nxb_reader&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      strings_(std::move(other.strings_)),
+      kernels_(std::move(other.kernels_)),
+      version_(other.version_),
+      recovered_(other.recovered_) {}
+
+nxb_reader::~nxb_reader() {
+  if (data_) {
+    munmap(const_cast<unsigned char*>(data_), size_);
+  }
+}
+
+bool nxb_reader::load_index() {
+  if (size_ < header_size + trailer_size) {
+    return false;
+  }
+  const auto* trailer = data_ + size_ - trailer_size;
+  if (std::memcmp(trailer + 8, nxb_trailer_magic, sizeof(nxb_trailer_magic)) != 0) {
+    return false;
+  }
+  const auto index_offset = get_u64(trailer);
+  const auto fixed = sizeof(nxb_index_magic) + 16;
+  if (index_offset < header_size || index_offset + fixed > size_ - trailer_size) {
+    return false;
+  }
+  const auto* p = data_ + index_offset;
+  if (std::memcmp(p, nxb_index_magic, sizeof(nxb_index_magic)) != 0) {
+    return false;
+  }
+  const auto num_strings = get_u64(p + 8);
+  const auto num_kernels = get_u64(p + 16);
+  const auto entries = size_ - trailer_size - index_offset - fixed;
+  if (num_strings > entries / 8 || num_kernels > (entries - num_strings * 8) / 16) {
+    return false;
+  }
+  p += fixed;
+  strings_.resize(num_strings);
+  for (auto& offset : strings_) {
+    offset = get_u64(p);
+    p += 8;
+  }
+  kernels_.resize(num_kernels);
+  for (auto& [name, offset] : kernels_) {
+    name = get_u64(p);
+    offset = get_u64(p + 8);
+    p += 16;
+  }
+  return true;
+}
+
+bool nxb_reader::scan_blocks() {
+  const auto* p = data_ + header_size;
+  const auto* end = data_ + size_;
+  while (p < end) {
+    const auto block_offset = static_cast<std::uint64_t>(p - data_);
+    const auto type = static_cast<nxb_block>(*p++);
+    std::uint64_t payload_size;
+    if (!get_varint(p, end, payload_size) ||
+        payload_size > static_cast<std::uint64_t>(end - p)) {
+      break;  // the last block was cut short
+    }
+    const auto* payload = p;
+    p += payload_size;
+
+    if (type == nxb_block::STRINGS) {
+      std::uint64_t count;
+      if (!get_varint(payload, p, count)) {
+        break;
+      }
+      for (std::uint64_t i = 0; i < count; i++) {
+        strings_.push_back(payload - data_);
+        std::uint64_t length;
+        if (!get_varint(payload, p, length) ||
+            length > static_cast<std::uint64_t>(p - payload)) {
+          return false;
+        }
+        payload += length;
+      }
+    } else if (type == nxb_block::KERNEL) {
+      std::uint64_t name;
+      if (!get_varint(payload, p, name)) {
+        break;
+      }
+      kernels_.emplace_back(name, block_offset);
+    } else {
+      break;  // the index, or garbage
+    }
+  }
+  return true;
+}
+
+std::string_view nxb_reader::string(std::uint64_t id) const {
+  if (id >= strings_.size() || strings_[id] >= size_) {
+    return {};
+  }
+  const auto* p = data_ + strings_[id];
+  const auto* end = data_ + size_;
+  std::uint64_t length;
+  if (!get_varint(p, end, length) || length > static_cast<std::uint64_t>(end - p)) {
+    return {};
+  }
+  return {reinterpret_cast<const char*>(p), length};
+}
+
+std::string_view nxb_reader::kernel_name(std::size_t index) const {
+  return string(kernels_[index].first);
+}
+
+bool nxb_reader::read_kernel(std::size_t index, kernel_record& record) const {
+  const auto offset = kernels_[index].second;
+  if (offset >= size_ || static_cast<nxb_block>(data_[offset]) != nxb_block::KERNEL) {
+    return false;
+  }
+  const auto* p = data_ + offset + 1;
+  const auto* end = data_ + size_;
+  std::uint64_t payload_size;
+  if (!get_varint(p, end, payload_size) ||
+      payload_size > static_cast<std::uint64_t>(end - p)) {
+    return false;
+  }
+  end = p + payload_size;
+
+  std::uint64_t name, signature, count;
+  if (!get_varint(p, end, name) || !get_varint(p, end, signature) ||
+      !get_varint(p, end, count) || count > payload_size) {
+    return false;
+  }
+  record.name = string(name);
+  record.signature = string(signature);
+  record.lines.resize(count);
+  std::int64_t line = 0;
+  for (auto& value : record.lines) {
+    std::uint64_t delta;
+    if (!get_varint(p, end, delta)) {
+      return false;
+    }
+    line += unzigzag(delta);
+    value = static_cast<std::uint32_t>(line);
+  }
+  const auto get_strings = [&](auto& strings) {
+    if (!get_varint(p, end, count) || count > payload_size) {
+      return false;
+    }
+    strings.resize(count);
+    for (auto& s : strings) {
+      std::uint64_t id;
+      if (!get_varint(p, end, id)) {
+        return false;
+      }
+      s = string(id);
+    }
+    return true;
+  };
+  if (!get_strings(record.files) || !get_strings(record.hip) ||
+      !get_strings(record.assembly)) {
+    return false;
+  }
+  record.source_index.clear();
+  if (version_ < 2) {
+    return true;
+  }
+  if (!get_varint(p, end, count) || count > payload_size) {
+    return false;
+  }
+  record.source_index.resize(count);
+  for (auto& index : record.source_index) {
+    std::uint64_t value;
+    if (!get_varint(p, end, value)) {
+      return false;
+    }
+    index = static_cast<std::int32_t>(value) - 1;
+  }
+  return true;
+}
+
+}  // namespace maestro
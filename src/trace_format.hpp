@@ -0,0 +1,166 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace maestro {
+
+// One traced kernel, as written to the trace. lines, files and hip are
+// parallel arrays, and so are assembly and source_index, which gives the
+// position in lines of each instruction's source line (-1 for none).
+// assembly views text owned elsewhere (an isa_store, or the mapping of the
+// file being read).
+struct kernel_record {
+  std::string name;
+  std::string signature;
+  std::vector<std::uint32_t> lines;
+  std::vector<std::string> files;
+  std::vector<std::string> hip;
+  std::vector<std::string_view> assembly;
+  std::vector<std::int32_t> source_index;
+  // When set, the JSON record names an earlier kernel with the same assembly
+  // instead of repeating it
+  std::string assembly_ref;
+};
+
+// The record object of the JSON trace schema
+nlohmann::json to_json(const kernel_record& record);
+
+// Binary trace (.nxb). After a fixed header the file is a sequence of blocks
+//
+//   block    := type:u8 payload_size:varint payload
+//   STRINGS  := count:varint (length:varint bytes)*
+//   KERNEL   := name:varint signature:varint
+//               n:varint zigzag-delta line:varint * n
+//               n:varint file:varint * n   n:varint hip:varint * n
+//               n:varint assembly:varint * n
+//               n:varint (source_index + 1):varint * n     (version 2)
+//
+// where names, files, source lines and ISA text are ids into the string
+// table that STRINGS blocks extend (each string is written once, before the
+// first kernel that uses it). finish() appends an index of fixed-width
+// little-endian offsets so a reader can mmap the file and go straight to any
+// string or kernel:
+//
+//   INDEX    := "NXINDEX1" num_strings:u64 num_kernels:u64
+//               string_offset:u64 * num_strings
+//               (name:u64 kernel_offset:u64) * num_kernels
+//   trailer  := index_offset:u64 "NXTRAIL1"
+//
+// A file cut short by a crash has no trailer; readers then rebuild the index
+// by walking the blocks.
+inline constexpr char nxb_magic[8] = {'N', 'X', 'T', 'R', 'A', 'C', 'E', '1'};
+inline constexpr char nxb_index_magic[8] = {'N', 'X', 'I', 'N', 'D', 'E', 'X', '1'};
+inline constexpr char nxb_trailer_magic[8] = {'N', 'X', 'T', 'R', 'A', 'I', 'L', '1'};
+
+enum struct nxb_block : std::uint8_t {
+  STRINGS = 1,
+  KERNEL = 2,
+};
+
+void put_varint(std::string& out, std::uint64_t value);
+// Returns false on truncated input
+bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value);
+
+// Turns kernel records into .nxb bytes; the caller writes them in order.
+class nxb_encoder {
+ public:
+  nxb_encoder();
+
+  // The file header
+  std::string header() const;
+
+  // Appends the blocks of one kernel to out
+  void encode(const kernel_record& record, std::string& out);
+
+  // Appends the index and trailer to out
+  void finish(std::string& out);
+
+  // Bytes held by the string table
+  std::size_t string_bytes() const { return string_bytes_; }
+
+ private:
+  struct string_hash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  std::uint32_t intern(std::string_view s);
+  void append_block(nxb_block type, const std::string& payload, std::string& out);
+
+  std::unordered_map<std::string, std::uint32_t, string_hash, std::equal_to<>> ids_;
+  std::vector<std::uint64_t> string_offsets_;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> kernels_;  // name, offset
+  std::string pending_strings_;
+  std::size_t num_pending_{0};
+  std::size_t string_bytes_{0};
+  std::uint64_t offset_;
+};
+
+// Read-only view of an .nxb file.
+class nxb_reader {
+ public:
+  // nullopt if the file cannot be mapped or is not a binary trace
+  static std::optional<nxb_reader> open(const std::filesystem::path& path);
+
+  nxb_reader(nxb_reader&& other) noexcept;
+  nxb_reader& operator=(nxb_reader&&) = delete;
+  ~nxb_reader();
+
+  std::size_t num_kernels() const { return kernels_.size(); }
+  std::string_view string(std::uint64_t id) const;
+  std::string_view kernel_name(std::size_t index) const;
+  // False when the kernel's block is malformed
+  bool read_kernel(std::size_t index, kernel_record& record) const;
+
+  // Whether the index was rebuilt because the trailer was missing
+  bool recovered() const { return recovered_; }
+
+ private:
+  nxb_reader() = default;
+  bool load_index();
+  bool scan_blocks();
+
+  const unsigned char* data_{nullptr};
+  std::size_t size_{0};
+  std::vector<std::uint64_t> strings_;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> kernels_;
+  std::uint64_t version_{0};
+  bool recovered_{false};
+};
+
+}  // namespace maestro
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include "trace_writer.hpp"
+
+#include <system_error>
+
+#include "log.hpp"
+
+namespace maestro {
+
+trace_writer::trace_writer(std::filesystem::path output, trace_format format)
+    : output_(std::move(output)),
+      format_(format),
+      stream_path_(format == trace_format::BINARY
+                       ? output_
+                       : std::filesystem::path(output_.string() + ".ndjson")),
+      stream_(stream_path_, std::ios::out | std::ios::trunc | std::ios::binary) {
+  if (!stream_) {
+    LOG_ERROR("Failed to open trace stream {}", stream_path_.string());
+  }
+  if (format_ == trace_format::BINARY) {
+    encoder_ = std::make_unique<nxb_encoder>();
+    const auto header = encoder_->header();
+    stream_.write(header.data(), static_cast<std::streamsize>(header.size()));
+  }
+}
+
+trace_writer::~trace_writer() {
+  finish();
+}
+
+void trace_writer::write_kernel(const kernel_record& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (finished_ || !stream_) {
+    return;
+  }
+
+  buffer_.clear();
+  if (encoder_) {
+    encoder_->encode(record, buffer_);
+  } else {
+    nlohmann::json line;
+    line["kernel"] = record.name;
+    line["record"] = to_json(record);
+    buffer_ = line.dump() + "\n";
+  }
+  stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  stream_.flush();
+  LOG_DETAIL("Streamed kernel {} to {}", record.name, stream_path_.string());
+}
+
+void trace_writer::finish() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+
+  if (encoder_) {
+    buffer_.clear();
+    encoder_->finish(buffer_);
+    stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    stream_.close();
+    LOG_DETAIL("Wrote binary trace {} ({} bytes of strings)",
+               output_.string(),
+               encoder_->string_bytes());
+    return;
+  }
+  stream_.close();
+
+  const auto count = convert(stream_path_, output_);
+  LOG_DETAIL("Wrote {} kernels to {}", count, output_.string());
+
+  std::error_code ec;
+  std::filesystem::remove(stream_path_, ec);
+}
+
+std::string trace_writer::format_entry(const std::string& name,
+                                       const nlohmann::json& record) {
+  // Records are re-indented so the output keeps the 4-space layout without
+  // holding every kernel in one document
+  const auto text = record.dump(4);
+  std::string entry = "        " + nlohmann::json(name).dump() + ": ";
+  entry.reserve(entry.size() + text.size() + text.size() / 8);
+  for (const char c : text) {
+    entry.push_back(c);
+    if (c == '\n') {
+      entry += "        ";
+    }
+  }
+  return entry;
+}
+
+std::size_t trace_writer::convert(const std::filesystem::path& ndjson_path,
+                                  const std::filesystem::path& json_path) {
+  std::ifstream in(ndjson_path);
+  if (!in) {
+    LOG_WARN("Failed to open trace stream {}", ndjson_path.string());
+    return 0;
+  }
+
+  // Write next to the destination so the final rename cannot cross devices
+  auto tmp_path = json_path;
+  tmp_path += ".tmp";
+  std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    LOG_ERROR("Failed to write JSON to: {}", tmp_path.string());
+    return 0;
+  }
+
+  std::size_t count = 0;
+  std::string line;
+  out << document_begin;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto parsed = nlohmann::json::parse(line, nullptr, false);
+    if (parsed.is_discarded() || !parsed.contains("kernel") ||
+        !parsed.contains("record")) {
+      LOG_WARN("Skipping malformed trace record in {}", ndjson_path.string());
+      continue;
+    }
+    out << entry_separator(count)
+        << format_entry(parsed["kernel"].get<std::string>(), parsed["record"]);
+    count++;
+  }
+  out << document_end(count);
+  out.close();
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, json_path, ec);
+  if (ec) {
+    LOG_ERROR("Failed to move {} to {}: {}",
+              tmp_path.string(),
+              json_path.string(),
+              ec.message());
+    return 0;
+  }
+  return count;
+}
+
+}  // namespace maestro
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+#include "trace_format.hpp"
+
+namespace maestro {
+
+enum struct trace_format {
+  JSON,    // NDJSON stream, converted to one JSON document by finish()
+  BINARY,  // .nxb, see trace_format.hpp
+};
+
+// Streams extracted kernel records to disk as they are discovered.
+//
+// JSON: records go to `<output>.ndjson`, one JSON object per line, and
+// finish() converts the stream into the `{"kernels": {...}}` document at
+// `output` and replaces it atomically.
+//
+// BINARY: records are appended to `output` with strings interned, and
+// finish() adds the index. tools/nexus_trace_convert turns the file into the
+// same JSON document.
+class trace_writer {
+ public:
+  explicit trace_writer(std::filesystem::path output,
+                        trace_format format = trace_format::JSON);
+  ~trace_writer();
+
+  void write_kernel(const kernel_record& record);
+  void finish();
+
+  const std::filesystem::path& output_path() const { return output_; }
+  const std::filesystem::path& stream_path() const { return stream_path_; }
+
+  // Converts an NDJSON stream (possibly truncated by a crash) into the
+  // `{"kernels": {...}}` schema. Returns the number of kernels written.
+  static std::size_t convert(const std::filesystem::path& ndjson_path,
+                             const std::filesystem::path& json_path);
+
+  // Pieces of the JSON document, shared with the offline converter
+  static constexpr std::string_view document_begin = "{\n    \"kernels\": {";
+  static std::string format_entry(const std::string& name, const nlohmann::json& record);
+  static std::string_view entry_separator(std::size_t index) {
+    return index == 0 ? "\n" : ",\n";
+  }
+  static std::string_view document_end(std::size_t count) {
+    return count == 0 ? "}\n}\n" : "\n    }\n}\n";
+  }
+
+ private:
+  std::filesystem::path output_;
+  trace_format format_;
+  std::filesystem::path stream_path_;
+  std::ofstream stream_;
+  std::unique_ptr<nxb_encoder> encoder_;
+  std::string buffer_;
+  std::mutex mutex_;
+  bool finished_{false};
+};
+
+}  // namespace maestro
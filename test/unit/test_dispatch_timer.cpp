@@ -0,0 +1,293 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dispatch_timer.hpp"
+
+#define CHECK(cond)                                                              \
+  do {                                                                           \
+    if (!(cond)) {                                                               \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                                \
+    }                                                                            \
+  } while (0)
+
+namespace {
+
+int failures = 0;
+
+// Fake runtime: signals are plain integers, completions are fired by the
+// test, and each signal reports the timestamps queued for it.
+struct fake_runtime {
+  struct registration {
+    std::uint64_t signal;
+    maestro::dispatch_timer_api::completion_handler handler;
+    void* arg;
+  };
+
+  std::mutex mutex;
+  std::uint64_t next_signal{1};
+  std::set<std::uint64_t> live;
+  std::uint64_t created{0};
+  std::uint64_t destroyed{0};
+  std::uint64_t resets{0};
+  std::map<std::uint64_t, std::uint64_t> forwarded;
+  std::vector<registration> pending;
+  std::map<std::uint64_t, std::pair<std::uint64_t, std::uint64_t>> times;
+};
+
+fake_runtime* runtime = nullptr;
+
+maestro::dispatch_timer_api fake_api() {
+  maestro::dispatch_timer_api api{};
+  api.signal_create = [](std::uint64_t* signal) {
+    std::lock_guard g(runtime->mutex);
+    *signal = runtime->next_signal++;
+    runtime->live.insert(*signal);
+    runtime->created++;
+    return true;
+  };
+  api.signal_destroy = [](std::uint64_t signal) {
+    std::lock_guard g(runtime->mutex);
+    runtime->live.erase(signal);
+    runtime->destroyed++;
+  };
+  api.signal_reset = [](std::uint64_t) {
+    std::lock_guard g(runtime->mutex);
+    runtime->resets++;
+  };
+  api.signal_forward = [](std::uint64_t signal) {
+    std::lock_guard g(runtime->mutex);
+    runtime->forwarded[signal]++;
+  };
+  api.on_completion = [](std::uint64_t signal,
+                         maestro::dispatch_timer_api::completion_handler handler,
+                         void* arg) {
+    std::lock_guard g(runtime->mutex);
+    runtime->pending.push_back({signal, handler, arg});
+    return true;
+  };
+  api.dispatch_time =
+      [](std::uint64_t, std::uint64_t signal, std::uint64_t* start, std::uint64_t* end) {
+        std::lock_guard g(runtime->mutex);
+        auto it = runtime->times.find(signal);
+        if (it == runtime->times.end()) {
+          return false;
+        }
+        *start = it->second.first;
+        *end = it->second.second;
+        return true;
+      };
+  return api;
+}
+
+// Completes the dispatch that got signal, as the runtime's signal thread would
+void complete(std::uint64_t signal, std::uint64_t start, std::uint64_t end) {
+  std::vector<fake_runtime::registration> fire;
+  {
+    std::lock_guard g(runtime->mutex);
+    runtime->times[signal] = {start, end};
+    for (auto it = runtime->pending.begin(); it != runtime->pending.end();) {
+      if (it->signal == signal) {
+        fire.push_back(*it);
+        it = runtime->pending.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (const auto& r : fire) {
+    r.handler(0, r.arg);
+  }
+}
+
+// Waits for the harvester to process completed dispatches
+bool wait_completed(const maestro::dispatch_timer& timer, std::uint64_t count) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (timer.get_counters().completed < count) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+constexpr std::uint64_t kernel_a = 0x7f0000001000;
+constexpr std::uint64_t kernel_b = 0x7f0000002000;
+constexpr std::uint64_t agent = 0x1234;
+
+void test_forwards_app_signal_once() {
+  fake_runtime fake;
+  runtime = &fake;
+  {
+    maestro::dispatch_timer timer(fake_api(), 4);
+    for (std::uint64_t i = 0; i < 8; i++) {
+      const std::uint64_t app_signal = 100 + i;
+      auto signal = timer.attach(kernel_a, agent, app_signal);
+      CHECK(signal.has_value());
+      if (!signal) {
+        continue;
+      }
+      CHECK(*signal != app_signal);
+      complete(*signal, 1000 * i, 1000 * i + 10);
+      CHECK(wait_completed(timer, i + 1));
+    }
+    // Dispatches without an application signal have nothing to forward
+    auto signal = timer.attach(kernel_a, agent, 0);
+    CHECK(signal.has_value());
+    complete(*signal, 9000, 9010);
+    CHECK(wait_completed(timer, 9));
+    timer.stop();
+  }
+  CHECK(fake.forwarded.size() == 8);
+  for (std::uint64_t i = 0; i < 8; i++) {
+    CHECK(fake.forwarded[100 + i] == 1);
+  }
+  CHECK(fake.forwarded.count(0) == 0);
+  runtime = nullptr;
+}
+
+void test_reuses_pooled_signals() {
+  fake_runtime fake;
+  runtime = &fake;
+  {
+    maestro::dispatch_timer timer(fake_api(), 2);
+    std::set<std::uint64_t> seen;
+    for (std::uint64_t i = 0; i < 16; i++) {
+      auto signal = timer.attach(kernel_a, agent, 100);
+      CHECK(signal.has_value());
+      if (!signal) {
+        continue;
+      }
+      seen.insert(*signal);
+      complete(*signal, 10 * i, 10 * i + 5);
+      CHECK(wait_completed(timer, i + 1));
+    }
+    CHECK(seen.size() <= 2);
+    {
+      std::lock_guard g(fake.mutex);
+      CHECK(fake.created == seen.size());
+      CHECK(fake.resets == 16);
+    }
+
+    // With every pooled signal in flight the dispatch is left untimed
+    auto first = timer.attach(kernel_a, agent, 100);
+    auto second = timer.attach(kernel_a, agent, 100);
+    CHECK(first.has_value() && second.has_value());
+    CHECK(!timer.attach(kernel_a, agent, 100).has_value());
+    CHECK(timer.get_counters().exhausted == 1);
+    {
+      std::lock_guard g(fake.mutex);
+      CHECK(fake.created == 2);
+    }
+    complete(*first, 0, 1);
+    complete(*second, 0, 1);
+    timer.stop();
+  }
+  CHECK(fake.destroyed == fake.created);
+  CHECK(fake.live.empty());
+  runtime = nullptr;
+}
+
+void test_timestamps_and_stats() {
+  fake_runtime fake;
+  runtime = &fake;
+  maestro::dispatch_timer timer(fake_api(), 8);
+
+  struct dispatch {
+    std::uint64_t kernel_object;
+    std::uint64_t start;
+    std::uint64_t end;
+  };
+  const std::vector<dispatch> dispatches = {
+      {kernel_a, 1000, 1500},  // 500
+      {kernel_b, 1200, 1300},  // 100
+      {kernel_a, 2000, 2300},  // 300
+      {kernel_a, 3000, 3700},  // 700
+  };
+
+  // Keep all of them in flight and complete them out of order
+  std::vector<std::uint64_t> signals;
+  for (const auto& d : dispatches) {
+    auto signal = timer.attach(d.kernel_object, agent, 42);
+    CHECK(signal.has_value());
+    signals.push_back(signal.value_or(0));
+  }
+  for (std::size_t i = dispatches.size(); i-- > 0;) {
+    complete(signals[i], dispatches[i].start, dispatches[i].end);
+  }
+  CHECK(wait_completed(timer, dispatches.size()));
+  timer.stop();
+
+  const auto timings = timer.get_timings();
+  CHECK(timings.size() == 2);
+
+  const auto& a = timings.at(kernel_a);
+  CHECK(a.dispatches == 3);
+  CHECK(a.total_ns == 1500);
+  CHECK(a.min_ns == 300);
+  CHECK(a.max_ns == 700);
+  CHECK(a.first_start == 1000);
+  CHECK(a.last_end == 3700);
+
+  const auto& b = timings.at(kernel_b);
+  CHECK(b.dispatches == 1);
+  CHECK(b.total_ns == 100);
+  CHECK(b.min_ns == 100);
+  CHECK(b.max_ns == 100);
+  CHECK(b.first_start == 1200);
+  CHECK(b.last_end == 1300);
+
+  const auto counters = timer.get_counters();
+  CHECK(counters.attached == 4);
+  CHECK(counters.completed == 4);
+  CHECK(counters.failed == 0);
+  CHECK(fake.forwarded[42] == 4);
+  runtime = nullptr;
+}
+
+}  // namespace
+
+int main() {
+  test_forwards_app_signal_once();
+  test_reuses_pooled_signals();
+  test_timestamps_and_stats();
+  if (failures != 0) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+
+// Converts a binary log written with NEXUS_LOG_BINARY=<path> to text.
+//
+//   nexus_log_decode <binary log> [-t]
+//
+// -t prefixes every line with its timestamp and thread id.
+
+#include <fmt/core.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "log.hpp"
+#include "log_sink.hpp"
+
+namespace {
+
+using maestro::detail::log_definition_id;
+using maestro::detail::log_record;
+
+struct definition {
+  int level;
+  int line;
+  std::string file;
+  std::string msg;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <binary log> [-t]\n", argv[0]);
+    return 1;
+  }
+  const bool timestamps = argc > 2 && std::string_view(argv[2]) == "-t";
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 1;
+  }
+  const std::vector<char> data{std::istreambuf_iterator<char>(in),
+                               std::istreambuf_iterator<char>()};
+
+  constexpr auto magic_size = sizeof(maestro::detail::log_file_magic);
+  if (data.size() < magic_size ||
+      std::memcmp(data.data(), maestro::detail::log_file_magic, magic_size) != 0) {
+    std::fprintf(stderr, "%s is not a nexus binary log\n", argv[1]);
+    return 1;
+  }
+
+  std::unordered_map<std::uint32_t, definition> definitions;
+  std::vector<char> record_buffer;
+  std::size_t offset = magic_size;
+  while (offset + 2 * sizeof(std::uint32_t) <= data.size()) {
+    std::uint32_t header[2];
+    std::memcpy(header, &data[offset], sizeof(header));
+    const auto size = header[0];
+    if (size < sizeof(header) || offset + size > data.size()) {
+      std::fprintf(stderr, "truncated entry at offset %zu\n", offset);
+      break;
+    }
+
+    if (header[1] == log_definition_id) {
+      std::uint32_t fields[7];
+      std::memcpy(fields, &data[offset], sizeof(fields));
+      const char* strings = &data[offset + sizeof(fields)];
+      definitions[fields[2]] = {static_cast<int>(fields[3]),
+                                static_cast<int>(fields[4]),
+                                std::string(strings, fields[5]),
+                                std::string(strings + fields[5], fields[6])};
+    } else {
+      // Copy out so the header and arguments are suitably aligned
+      record_buffer.assign(&data[offset], &data[offset] + size);
+      const auto& record = *reinterpret_cast<const log_record*>(record_buffer.data());
+      auto it = definitions.find(record.format_id);
+      if (it == definitions.end()) {
+        std::fprintf(stderr, "unknown format id %u\n", record.format_id);
+      } else {
+        const auto& d = it->second;
+        const auto level = static_cast<maestro::detail::LogLevel>(d.level);
+        if (timestamps) {
+          fmt::print("{}.{:09} [{}] ",
+                     record.timestamp / 1000000000,
+                     record.timestamp % 1000000000,
+                     record.thread_id);
+        }
+        fmt::print("[{}]: [{}:{}] {}\n",
+                   maestro::detail::log_level_to_string(level),
+                   d.file,
+                   d.line,
+                   maestro::detail::log_sink::format(d.msg.c_str(), record));
+      }
+    }
+    offset += size;
+  }
+  return 0;
+}
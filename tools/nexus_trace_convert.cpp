@@ -0,0 +1,141 @@
+/****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2025 Advanced Micro Devices, Inc. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ****************************************************************************/
+// Converts a binary trace written with NEXUS_TRACE_FORMAT=binary to the JSON
+// document nexus writes by default. Also rebuilds that document from the
+// `<output>.ndjson` stream left behind by a JSON run that did not exit
+// cleanly, exactly as nexus would have at exit.
+//
+//   nexus_trace_convert <trace.nxb | trace.json.ndjson> <output.json> [-j threads]
+//
+// Binary kernels are rendered in parallel and written in trace order.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "trace_format.hpp"
+#include "trace_writer.hpp"
+
+// NDJSON streams start with a record object
+static bool is_ndjson(const char* path) {
+  std::ifstream in(path);
+  char c = 0;
+  while (in.get(c) && std::isspace(static_cast<unsigned char>(c))) {
+  }
+  return in && c == '{';
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::fprintf(stderr,
+                 "usage: %s <trace.nxb | trace.json.ndjson> <output.json> [-j threads]\n",
+                 argv[0]);
+    return 1;
+  }
+  std::size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (argc > 4 && std::string_view(argv[3]) == "-j") {
+    num_threads = std::max(1, std::atoi(argv[4]));
+  }
+
+  auto reader = maestro::nxb_reader::open(argv[1]);
+  if (!reader && is_ndjson(argv[1])) {
+    const auto written = maestro::trace_writer::convert(argv[1], argv[2]);
+    std::printf("%zu kernels written to %s\n", written, argv[2]);
+    return 0;
+  }
+  if (!reader) {
+    std::fprintf(
+        stderr, "%s is neither a nexus binary trace nor an NDJSON stream\n", argv[1]);
+    return 1;
+  }
+  if (reader->recovered()) {
+    std::fprintf(stderr,
+                 "%s has no index (truncated?), recovered %zu kernels\n",
+                 argv[1],
+                 reader->num_kernels());
+  }
+
+  const std::string tmp_path = std::string(argv[2]) + ".tmp";
+  std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    std::fprintf(stderr, "cannot write %s\n", tmp_path.c_str());
+    return 1;
+  }
+
+  // Render a window of kernels at a time so memory stays bounded
+  const std::size_t window = num_threads * 64;
+  std::vector<std::string> entries(window);
+  std::size_t written = 0;
+  std::size_t malformed = 0;
+  out << maestro::trace_writer::document_begin;
+  for (std::size_t first = 0; first < reader->num_kernels(); first += window) {
+    const auto count = std::min(window, reader->num_kernels() - first);
+    std::vector<std::thread> workers;
+    std::vector<std::size_t> failed(num_threads, 0);
+    for (std::size_t t = 0; t < num_threads; t++) {
+      workers.emplace_back([&, t] {
+        maestro::kernel_record record;
+        for (std::size_t i = t; i < count; i += num_threads) {
+          entries[i].clear();
+          if (!reader->read_kernel(first + i, record)) {
+            failed[t]++;
+            continue;
+          }
+          entries[i] = maestro::trace_writer::format_entry(record.name,
+                                                           maestro::to_json(record));
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    for (std::size_t i = 0; i < count; i++) {
+      if (!entries[i].empty()) {
+        out << maestro::trace_writer::entry_separator(written) << entries[i];
+        written++;
+      }
+    }
+    for (const auto n : failed) {
+      malformed += n;
+    }
+  }
+  out << maestro::trace_writer::document_end(written);
+  out.close();
+
+  if (std::rename(tmp_path.c_str(), argv[2]) != 0) {
+    std::fprintf(stderr, "cannot move %s to %s\n", tmp_path.c_str(), argv[2]);
+    return 1;
+  }
+  if (malformed) {
+    std::fprintf(stderr, "skipped %zu malformed kernels\n", malformed);
+  }
+  std::printf("%zu kernels written to %s\n", written, argv[2]);
+  return 0;
+}